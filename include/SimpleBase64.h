@@ -32,6 +32,30 @@ namespace SimpleBase64 {
 
     inline std::string encode(const std::vector<std::uint8_t>& data) { return encode(data.data(), data.size()); }
 
+    // 编码后的长度（含填充）
+    constexpr std::size_t encoded_size(std::size_t len) { return (len + 2) / 3 * 4; }
+
+    // 编码到调用方提供的缓冲区，out 至少需要 encoded_size(len) 字节，返回写入的字节数
+    inline std::size_t encode_to(const std::uint8_t* data, std::size_t len, char* out) {
+        char* p = out;
+        std::size_t i = 0;
+        for (; i + 3 <= len; i += 3) {
+            const std::uint32_t v = (std::uint32_t(data[i]) << 16) | (std::uint32_t(data[i + 1]) << 8) | data[i + 2];
+            *p++ = base64_chars[(v >> 18) & 0x3F];
+            *p++ = base64_chars[(v >> 12) & 0x3F];
+            *p++ = base64_chars[(v >> 6) & 0x3F];
+            *p++ = base64_chars[v & 0x3F];
+        }
+        if (const std::size_t rest = len - i; rest > 0) {
+            const std::uint32_t v = (std::uint32_t(data[i]) << 16) | (rest == 2 ? std::uint32_t(data[i + 1]) << 8 : 0);
+            *p++ = base64_chars[(v >> 18) & 0x3F];
+            *p++ = base64_chars[(v >> 12) & 0x3F];
+            *p++ = rest == 2 ? base64_chars[(v >> 6) & 0x3F] : '=';
+            *p++ = '=';
+        }
+        return static_cast<std::size_t>(p - out);
+    }
+
     // 解码
     inline std::vector<std::uint8_t> decode(const std::string& str) {
         std::vector<std::uint8_t> ret;
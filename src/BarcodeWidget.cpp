@@ -1,15 +1,27 @@
 #include "BarcodeWidget.h"
 #include "LanguageManager.h"
 #include "about_dialog.h"
+#include "batch/Journal.h"
+#include "batch/MailMerge.h"
 #include "components/UiConfig.h"
 #include "components/message_dialog.h"
 #include "convert.h"
+#include "io/ArchiveReader.h"
+#include "io/ArchiveSink.h"
+#include "io/HotFolderWatcher.h"
+#include "io/PrintSheet.h"
+#include "io/TableReader.h"
 #include "version_info/version.h"
+#include <QActionGroup>
 #include <QCheckBox>
 #include <QClipboard>
 #include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
 #include <QFileDialog>
 #include <QFont>
+#include <QFormLayout>
 #include <QFutureWatcher>
 #include <QGridLayout>
 #include <QGuiApplication>
@@ -22,17 +34,23 @@
 #include <QPainter>
 #include <QPixmap>
 #include <QProgressBar>
+#include <QProgressDialog>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QSignalBlocker>
+#include <QThread>
 #include <QtConcurrent>
 #include <SimpleBase64.h>
 #include <ZXing/BarcodeFormat.h>
 #include <ZXing/TextUtfEncoding.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <magic_enum/magic_enum.hpp>
 #include <opencv2/opencv.hpp>
 #include <ranges>
 #include <spdlog/spdlog.h>
+#include <utility>
 
 template <typename Ret, typename... Fs>
 requires(std::is_void_v<Ret> || std::is_default_constructible_v<Ret>)
@@ -128,6 +146,7 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     toolsMenu = menuBar->addMenu(tr("工具"));
     settingMenu = menuBar->addMenu(tr("设置"));
     languageSubMenu = settingMenu->addMenu(tr("语言"));
+    outputFormatSubMenu = settingMenu->addMenu(tr("保存格式"));
 
     menuBar->setFont(Ui::getAppFont(12));
 
@@ -143,11 +162,59 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     directTextAction->setCheckable(true);
     directTextAction->setChecked(false); // 默认不勾选
 
+    archiveOutputAction = new QAction(tr("批量保存为归档"), this);
+    archiveOutputAction->setCheckable(true);
+    archiveOutputAction->setChecked(false); // 默认逐个文件保存
+
+    verifyAction = new QAction(tr("生成后校验"), this);
+    verifyAction->setCheckable(true);
+    verifyAction->setChecked(false); // 默认不校验
+
+    resumeAction = new QAction(tr("批量生成时跳过已完成的文件"), this);
+    resumeAction->setCheckable(true);
+    resumeAction->setChecked(false); // 默认生成后再选择保存位置
+
+    folderModeAction = new QAction(tr("文件夹模式"), this);
+    folderModeAction->setCheckable(true);
+    folderModeAction->setChecked(false); // 默认选择文件
+
+    hotFolderAction = new QAction(tr("监视文件夹"), this);
+    hotFolderAction->setCheckable(true);
+    hotFolderAction->setChecked(false);
+
+    // 保存格式，SVG/PDF 直接由模块矩阵输出矢量图形，默认 PNG
+    outputFormatGroup = new QActionGroup(this);
+    outputFormatGroup->setExclusive(true);
+    for (const auto &[name, format] : {std::pair{"PNG", convert::output_format::png},
+                                       std::pair{"SVG", convert::output_format::svg},
+                                       std::pair{"PDF", convert::output_format::pdf}}) {
+        auto *action = outputFormatSubMenu->addAction(name);
+        action->setCheckable(true);
+        action->setChecked(format == convert::output_format::png);
+        action->setData(static_cast<int>(format));
+        outputFormatGroup->addAction(action);
+    }
+    // 启用后忽略上面的尺寸和保存格式，每个输入按配置文件中的 output_profiles 各输出一份
+    outputFormatSubMenu->addSeparator();
+    outputProfilesAction = outputFormatSubMenu->addAction(tr("按输出配置生成多份"));
+    outputProfilesAction->setCheckable(true);
+    outputProfilesAction->setChecked(false);
+
+    mailMergeAction = new QAction(tr("表格批量生成"), this);
+    printSheetAction = new QAction(tr("打印排版 (PDF)"), this);
+
     helpMenu->addAction(aboutAction);
     toolsMenu->addAction(debugMqttAction);
     toolsMenu->addAction(openCameraScanAction);
+    toolsMenu->addAction(hotFolderAction);
+    toolsMenu->addAction(mailMergeAction);
+    toolsMenu->addAction(printSheetAction);
     settingMenu->addAction(base64CheckAcion);
     settingMenu->addAction(directTextAction);
+    settingMenu->addAction(archiveOutputAction);
+    settingMenu->addAction(folderModeAction);
+    settingMenu->addAction(verifyAction);
+    settingMenu->addAction(resumeAction);
 
     // 连接菜单项的点击信号
     connect(aboutAction, &QAction::triggered, this, &BarcodeWidget::showAbout);
@@ -157,6 +224,16 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
         preview.startCamera();
         preview.show();
     });
+    connect(outputProfilesAction, &QAction::toggled, outputFormatGroup, &QActionGroup::setDisabled);
+    connect(mailMergeAction, &QAction::triggered, this, &BarcodeWidget::onMailMergeClicked);
+    connect(printSheetAction, &QAction::triggered, this, &BarcodeWidget::onPrintSheetClicked);
+    connect(hotFolderAction, &QAction::toggled, this, [this](bool checked) {
+        if (checked) {
+            startHotFolder();
+        } else {
+            stopHotFolder();
+        }
+    });
 
     auto *mainLayout = new QVBoxLayout(this);
     mainLayout->setSpacing(15); // 调整控件之间的间距
@@ -211,6 +288,12 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     progressBar->setVisible(false);    // 默认隐藏，只有批量处理时才显示
     mainLayout->addWidget(progressBar);
 
+    watchStatusLabel = new QLabel(this);
+    watchStatusLabel->setObjectName("watchStatusLabel");
+    watchStatusLabel->setWordWrap(true);
+    watchStatusLabel->setVisible(false); // 只在监视文件夹时显示
+    mainLayout->addWidget(watchStatusLabel);
+
     // 图片展示区域
     scrollArea = new QScrollArea(this);
     scrollArea->setObjectName("scrollArea");
@@ -226,6 +309,16 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     configMainLayout->setVerticalSpacing(8);
 
     imageSizeConfig = ImageSizeConfig::loadFromConfig("./setting/config.json");
+    batchConfig = BatchConfig::loadFromConfig("./setting/config.json");
+    outputProfiles = OutputProfileConfig::loadFromConfig("./setting/config.json");
+    outputProfilesAction->setEnabled(!outputProfiles.empty());
+    memoryBudget = std::make_shared<batch::MemoryBudget>(batchConfig.getMemoryBudgetBytes());
+    spdlog::info("PNG encoder: {}, level={}, filter={}",
+                 io::PngEncoder::backendName(),
+                 batchConfig.pngCompressionLevel,
+                 batchConfig.pngFilter);
+    // 监视文件夹在后台常驻，只占一半线程，手动批处理仍使用全局线程池
+    watchPool.setMaxThreadCount(std::max(QThread::idealThreadCount() / 2, 1));
 
     formatLabel = new QLabel(tr("选择条码类型:"), this);
     formatLabel->setObjectName("configLabel");
@@ -297,7 +390,8 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
 
     mainLayout->addWidget(configWidget);
 
-    fileDialog = new QFileDialog(this, "Select File", "", "Supported Files (*.rfa *.txt *.png);;All Files (*)");
+    fileDialog =
+        new QFileDialog(this, "Select File", "", "Supported Files (*.rfa *.txt *.png *.zip *.tar);;All Files (*)");
     fileDialog->setModal(false);
 
     MqttConfig config = MqttSubscriber::loadMqttConfig("./setting/config.json");
@@ -390,8 +484,11 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     });
 
     connect(fileDialog, &QFileDialog::filesSelected, this, [this](const QStringList &filenames) {
-        filePathEdit->clear();
-        filePathEdit->setText(filenames.join(QDir::listSeparator()));
+        {
+            // 列表已知，不必经 textChanged 重新拆分和渲染一遍
+            const QSignalBlocker blocker(filePathEdit);
+            filePathEdit->setText(filenames.join(QDir::listSeparator()));
+        }
         lastSelectedFiles = filenames;
         lastResults.clear();
         renderResults();
@@ -417,6 +514,11 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     }
 }
 
+BarcodeWidget::~BarcodeWidget() {
+    // 常驻引擎的工作线程在 watchPool 中等待输入，必须先关闭，否则线程池析构时会一直等待
+    stopHotFolder();
+}
+
 void BarcodeWidget::updateButtonStates() const {
     saveButton->setEnabled(false);
 
@@ -424,7 +526,7 @@ void BarcodeWidget::updateButtonStates() const {
         generateButton->setEnabled(false);
         decodeToChemFile->setEnabled(false);
     } else {
-        if (lastSelectedFiles.size() == 1) {
+        if (lastSelectedFiles.size() == 1 && !io::ArchiveReader::isArchivePath(lastSelectedFiles.front())) {
             auto &file = lastSelectedFiles.front();
 
             bool isImage = fileExtensionRegex_image.match(file).hasMatch();
@@ -438,6 +540,13 @@ void BarcodeWidget::updateButtonStates() const {
 }
 
 void BarcodeWidget::onBrowseFile() const {
+    if (folderModeAction->isChecked()) {
+        fileDialog->setFileMode(QFileDialog::Directory);
+        fileDialog->setOption(QFileDialog::ShowDirsOnly, true);
+        fileDialog->setWindowTitle(tr("选择需要递归处理的文件夹"));
+        fileDialog->open();
+        return;
+    }
     fileDialog->setFileMode(QFileDialog::ExistingFiles);
     fileDialog->setOption(QFileDialog::ShowDirsOnly, false);
     fileDialog->setWindowTitle(tr("选择需要转换的文件或图片"));
@@ -455,6 +564,7 @@ void BarcodeWidget::onGenerateClicked() {
 
     const auto useBase64 = base64CheckAcion->isChecked();
     const auto format = currentBarcodeFormat;
+    batchJournal.reset();
 
     if (directTextAction->isChecked()) {
         QString rawText = filePathEdit->text();
@@ -484,6 +594,7 @@ void BarcodeWidget::onGenerateClicked() {
             int finalWidth;  // 最终目标宽度
             int finalHeight; // 最终目标高度
             int targePPI;
+            bool verify; // 生成后解码校验
 
             convert::result_data_entry operator()(const QString &textInput) const {
                 convert::result_data_entry res;
@@ -519,6 +630,11 @@ void BarcodeWidget::onGenerateClicked() {
                             "缩放后图片尺寸: {}x{}, 设置密度: {} DPI ({} DPM)", img.width(), img.height(), ppi, dpm);
 
                         res.data = img;
+                        if (verify) {
+                            res.verified = convert::verify_qimage(img, content, config.format)
+                                               ? convert::verify_status::passed
+                                               : convert::verify_status::failed;
+                        }
                         // 图片设置到剪贴板当中
                         QImage copyImg = img;
 
@@ -553,24 +669,49 @@ void BarcodeWidget::onGenerateClicked() {
             inputs,
             TextWorker{
                 useBase64, {targetWidth, targetHeight, format},
-                 targetWidth, targetHeight, targePPI
+                 targetWidth, targetHeight, targePPI, verifyAction->isChecked()
         }));
 
         return; // 结束函数，不再执行下方的文件处理逻辑
     }
 
+    auto archives = std::make_shared<io::ArchiveSet>();
+    QStringList folders;
+    const QStringList inputs = expandSelectedFiles(*archives, folders);
+
     QStringList filePaths;
-    filePaths.reserve(static_cast<int>(lastResults.size()));
+    filePaths.reserve(inputs.size());
 
     //因为先前的逻辑是不是图片就算文本，所以先这样吧
-    std::ranges::copy(lastSelectedFiles | std::views::filter([](const QString &file) {
+    std::ranges::copy(inputs | std::views::filter([](const QString &file) {
                           return !fileExtensionRegex_image.match(file).hasMatch();
                       }),
                       std::back_inserter(filePaths));
-    if (filePaths.empty()) {
+    if (filePaths.empty() && folders.empty()) {
         QMessageBox::warning(this, tr("警告"), tr("无可处理文件"));
         return;
     }
+
+    // 续做中断的批处理：先选定输出文件夹，其任务日志中输入和参数都未变、输出也未被改动的文件不再生成
+    const auto profiles = renderProfiles();
+    QByteArray salt;
+    if (resumeAction->isChecked()) {
+        const QString dir =
+            QFileDialog::getExistingDirectory(this,
+                                              tr("请选择保存文件夹"),
+                                              QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+                                              QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+        if (dir.isEmpty()) {
+            return;
+        }
+        QString journalError;
+        batchJournal = batch::Journal::open(dir, &journalError);
+        if (!batchJournal) {
+            QMessageBox::warning(this, tr("警告"), tr("无法打开任务日志，将重新处理所有文件: %1").arg(journalError));
+        }
+        salt = generateSalt(profiles.get());
+    }
+
     // 2. UI 状态准备
     progressBar->setVisible(true);
     progressBar->setRange(0, filePaths.size()); // 设置进度条范围
@@ -580,85 +721,40 @@ void BarcodeWidget::onGenerateClicked() {
     saveButton->setEnabled(false);
     this->setCursor(Qt::WaitCursor);
 
-    struct worker {
-        using result_type = convert::result_data_entry;
-        int reqWidth;
-        int reqHeight;
-        int finalWidth;  // 最终目标宽度
-        int finalHeight; // 最终目标高度
-        int targePPI;    // 目标PPI用于设置DPM
-        bool useBase64;
-        ZXing::BarcodeFormat format;
-
-        convert::result_data_entry operator()(const QString &filePath) const {
-            try {
-                QFile file(filePath);
-
-                convert::result_data_entry res;
-                if (!file.open(QIODevice::ReadOnly)) {
-                    res.data = QString(tr("无法打开文件: ")).toStdString() + filePath.toStdString();
-                    res.source_file_name = std::move(filePath);
-                    return res;
-                } else {
-                    res.source_file_name = std::move(filePath);
-                }
-
-                const QByteArray data = file.readAll();
-                file.close();
-
-                // 是否base64处理通过判断base64CheckBox
-                std::string text;
-                if (useBase64) {
-                    text = SimpleBase64::encode(reinterpret_cast<const std::uint8_t *>(data.constData()), data.size());
-                } else {
-                    text = data.toStdString();
-                }
-
-                auto img = convert::byte_to_QRCode_qimage(
-                    text, {.target_width = reqWidth, .target_height = reqHeight, .format = format, .margin = 1});
-
-                if (!img.isNull()) {
-                    // 缩放图像到精确尺寸
-                    img = convert::resizeImageToExactSize(img, finalWidth, finalHeight);
-
-                    // 设置图像DPI/DPM元数据
-                    int ppi = targePPI;
-                    int dpm = static_cast<int>(ppi / 0.0254);
-                    img.setDotsPerMeterX(dpm);
-                    img.setDotsPerMeterY(dpm);
-
-                    res.data = img;
-                } else {
-                    res.data = QString(tr("生成图片失败")).toStdString();
-                }
-
-                return res;
-            } catch (const std::exception &e) {
-                convert::result_data_entry res;
-                res.source_file_name = std::move(filePath);
-                res.data.emplace<std::string>(e.what());
-                return res;
-            }
-        }
-    };
-
     auto *watcher = new QFutureWatcher<convert::result_data_entry>(this);
 
-    connect(watcher,
-            &QFutureWatcher<convert::result_data_entry>::progressValueChanged,
-            progressBar,
-            &QProgressBar::setValue);
+    attachProgress(watcher);
 
     connect(
         watcher, &QFutureWatcher<convert::result_data_entry>::finished, [this, watcher] { onBatchFinish(*watcher); });
 
-    watcher->setFuture(QtConcurrent::mapped(
-        filePaths, worker{targetWidth, targetHeight, targetWidth, targetHeight, targePPI, useBase64, format}));
+    const batch::BatchEngine<QString, convert::result_data_entry> engine(
+        batch::GenerateWorker{targetWidth,
+                              targetHeight,
+                              targetWidth,
+                              targetHeight,
+                              targePPI,
+                              useBase64,
+                              format,
+                              memoryBudget,
+                              archives,
+                              outputFormat(),
+                              profiles,
+                              verifyAction->isChecked(),
+                              batchJournal,
+                              salt},
+        engineOptions());
+    engine.feed(std::vector<QString>(filePaths.begin(), filePaths.end()));
+    streamFolders(engine, archives, folders, io::InputKind::data);
+    watcher->setFuture(engine.future());
 }
 
 void BarcodeWidget::onDecodeToChemFileClicked() {
-    const QStringList filePaths = lastSelectedFiles.filter(fileExtensionRegex_image);
-    if (filePaths.empty()) {
+    batchJournal.reset();
+    auto archives = std::make_shared<io::ArchiveSet>();
+    QStringList folders;
+    const QStringList filePaths = expandSelectedFiles(*archives, folders).filter(fileExtensionRegex_image);
+    if (filePaths.empty() && folders.empty()) {
         QMessageBox::warning(this, tr("警告"), tr("无可处理文件"));
         return;
     }
@@ -672,47 +768,18 @@ void BarcodeWidget::onDecodeToChemFileClicked() {
     saveButton->setEnabled(false);
     this->setCursor(Qt::WaitCursor);
 
-    struct worker {
-        using result_type = convert::result_data_entry;
-
-        bool useBase64;
-        convert::result_data_entry operator()(QString path) const {
-            try {
-                const auto file_path = path.toLocal8Bit().toStdString();
-                switch (auto rst = convert::QRcode_to_byte(file_path); rst.err) {
-                case convert::result_i2t::empty_img:
-                    spdlog::error("cv::imread 无法加载图片文件: {}", path.toStdString());
-                    return {std::move(path), QString{tr("无法加载图片文件: %1")}.arg(path).toStdString()};
-                case convert::result_i2t::invalid_qrcode:
-                    return {std::move(path), QString{tr("无法识别条码或条码格式不正确")}.toStdString()};
-                default:
-                    std::vector<std::uint8_t> decodedData;
-                    if (useBase64) {
-                        decodedData = SimpleBase64::decode(rst.text);
-                    } else {
-                        decodedData = std::vector<std::uint8_t>(rst.text.begin(), rst.text.end());
-                    }
-                    return {std::move(path),
-                            QByteArray(reinterpret_cast<const char *>(decodedData.data()),
-                                       static_cast<int>(decodedData.size()))};
-                }
-            } catch (const std::exception &e) {
-                return {std::move(path), QString("解码失败:\n%1").arg(e.what()).toStdString()};
-            }
-        }
-    };
-
     auto *watcher = new QFutureWatcher<convert::result_data_entry>(this);
 
-    connect(watcher,
-            &QFutureWatcher<convert::result_data_entry>::progressValueChanged,
-            progressBar,
-            &QProgressBar::setValue);
+    attachProgress(watcher);
 
     connect(
         watcher, &QFutureWatcher<convert::result_data_entry>::finished, [this, watcher] { onBatchFinish(*watcher); });
 
-    watcher->setFuture(QtConcurrent::mapped(filePaths, worker{base64CheckAcion->isChecked()}));
+    const batch::BatchEngine<QString, convert::result_data_entry> engine(
+        batch::DecodeWorker{base64CheckAcion->isChecked(), memoryBudget, archives}, engineOptions());
+    engine.feed(std::vector<QString>(filePaths.begin(), filePaths.end()));
+    streamFolders(engine, archives, folders, io::InputKind::image);
+    watcher->setFuture(engine.future());
 }
 
 void BarcodeWidget::onSaveClicked() {
@@ -721,33 +788,24 @@ void BarcodeWidget::onSaveClicked() {
         return;
     }
 
-    struct SaveTask {
-        convert::result_data_entry entry;
-        QString dest;
-    };
-
-    struct SaveResult {
-        enum errcode {
-            success,
-            invalid_data,
-            failed,
-        };
-
-        errcode err;
-        QString path;
-    };
-
-    QList<SaveTask> tasks;
+    QList<batch::SaveTask> tasks;
+    std::shared_ptr<io::OutputSink> sink;
+    std::shared_ptr<batch::Journal> journal;
 
-    if (lastResults.size() == 1) {
+    if (lastResults.size() == 1 && lastResults.front().renditions.empty() && !batchJournal) {
         const auto &entry = lastResults.front();
 
         const QString defName = entry.get_default_target_name();
         auto fileName = std::visit<QString>(
             overload_def_noop{std::in_place_type<QString>,
                               [&](const QImage &) {
-                                  return QFileDialog::getSaveFileName(
-                                      this, tr("保存图片"), defName, "PNG Images (*.png)");
+                                  QString filter = "PNG Images (*.png)";
+                                  if (entry.modules) {
+                                      filter = entry.modules->format == convert::output_format::pdf
+                                                   ? "PDF Files (*.pdf)"
+                                                   : "SVG Images (*.svg)";
+                                  }
+                                  return QFileDialog::getSaveFileName(this, tr("保存图片"), defName, filter);
                               },
                               [&](const QByteArray &) {
                                   return QFileDialog::getSaveFileName(
@@ -758,26 +816,35 @@ void BarcodeWidget::onSaveClicked() {
         if (fileName.isEmpty()) {
             return;
         }
+        sink = std::make_shared<io::DirectorySink>(QFileInfo(fileName).absolutePath());
         tasks.append({entry, std::move(fileName)});
+    } else if (batchJournal) {
+        // 续做的批处理写入生成前选定的文件夹，按输入记录任务日志
+        sink = std::make_shared<io::DirectorySink>(QFileInfo(batchJournal->path()).absolutePath());
+        journal = batchJournal;
     } else {
-        const QString dir =
-            QFileDialog::getExistingDirectory(this,
-                                              tr("请选择保存文件夹"),
-                                              QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
-                                              QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
-
-        if (dir.isEmpty()) {
+        sink = chooseBatchSink();
+        if (!sink) {
             return;
         }
-
-        const QDir outputDir(dir);
+        // 保存到文件夹时记录任务日志，中断后再次保存到同一文件夹只写出未完成的文件
+        if (std::dynamic_pointer_cast<io::DirectorySink>(sink)) {
+            QString journalError;
+            journal = batch::Journal::open(sink->location(), &journalError);
+            if (!journal) {
+                spdlog::warn("Cannot open job journal, saving without it: {}", journalError.toStdString());
+            }
+        }
         for (const auto &entry : lastResults) {
             if (!entry) {
                 continue;
             }
-
-            const QString fileName = outputDir.filePath(entry.get_default_target_name());
-            tasks.append({entry, std::move(fileName)});
+            if (entry.renditions.empty()) {
+                tasks.append({entry, entry.get_default_target_name()});
+            }
+            for (const auto &rendition : entry.renditions) {
+                tasks.append({rendition, rendition.get_default_target_name()});
+            }
         }
     }
 
@@ -793,44 +860,11 @@ void BarcodeWidget::onSaveClicked() {
     decodeToChemFile->setEnabled(false);
     this->setCursor(Qt::WaitCursor);
 
-    struct worker {
-        using result_type = SaveResult;
-        SaveResult operator()(const SaveTask &task) const noexcept try {
-            return std::visit<SaveResult>(
-                overload_def_noop{std::in_place_type<SaveResult>,
-                                  [&](const QImage &img) -> SaveResult {
-                                      if (img.isNull()) {
-                                          return {SaveResult::invalid_data, task.dest};
-                                      }
-                                      if (img.save(task.dest)) {
-                                          return {SaveResult::success, task.dest};
-                                      } else {
-                                          return {SaveResult::failed, task.dest};
-                                      }
-                                  },
-                                  [&](const QByteArray &data) -> SaveResult {
-                                      if (data.isEmpty()) {
-                                          return {SaveResult::invalid_data, task.dest};
-                                      }
-
-                                      QFile f(task.dest);
-                                      if (f.open(QIODevice::WriteOnly)) {
-                                          f.write(data);
-                                          f.close();
-                                          return {SaveResult::success, task.dest};
-                                      }
-                                      return {SaveResult::failed, task.dest};
-                                  },
-                                  [&](const auto &) noexcept { return SaveResult{SaveResult::failed, task.dest}; }},
-                task.entry.data);
-        } catch (...) { return {SaveResult::failed}; }
-    };
-
-    auto *watcher = new QFutureWatcher<SaveResult>(this);
+    auto *watcher = new QFutureWatcher<batch::SaveResult>(this);
 
-    connect(watcher, &QFutureWatcher<SaveResult>::progressValueChanged, progressBar, &QProgressBar::setValue);
+    attachProgress(watcher);
 
-    connect(watcher, &QFutureWatcher<SaveResult>::finished, [this, watcher]() {
+    connect(watcher, &QFutureWatcher<batch::SaveResult>::finished, [this, watcher, sink]() {
         this->setCursor(Qt::ArrowCursor);
         progressBar->setVisible(false);
 
@@ -842,13 +876,21 @@ void BarcodeWidget::onSaveClicked() {
         auto list = watcher->future().results();
 
         int successCount = 0;
+        int skippedCount = 0;
         QStringList failedInfos;
         QStringList successInfos;
 
+        // 归档在此写入清单和目录，失败时整个归档无效
+        if (!sink->finish()) {
+            failedInfos.append(QString("• %1 (%2)").arg(QFileInfo(sink->location()).fileName(), sink->errorString()));
+        }
+
         for (const auto &res : list) {
             QString fileName = QFileInfo(res.path).fileName();
 
-            if (res.err == SaveResult::success) {
+            if (res.err == batch::SaveResult::skipped) {
+                ++skippedCount;
+            } else if (res.err == batch::SaveResult::success) {
                 successCount++;
                 // 如果总数不多，记录成功的文件名用于展示
                 if (list.size() <= 10) {
@@ -857,8 +899,8 @@ void BarcodeWidget::onSaveClicked() {
             } else {
                 QString reason;
                 switch (res.err) {
-                case SaveResult::invalid_data: reason = tr("数据为空或无效"); break;
-                case SaveResult::failed: reason = tr("写入失败"); break;
+                case batch::SaveResult::invalid_data: reason = tr("数据为空或无效"); break;
+                case batch::SaveResult::failed: reason = tr("写入失败"); break;
                 default: reason = tr("未知错误"); break;
                 }
                 failedInfos.append(QString("• %1 (%2)").arg(fileName, reason));
@@ -870,6 +912,9 @@ void BarcodeWidget::onSaveClicked() {
                           .arg(list.size())
                           .arg(successCount)
                           .arg(failedInfos.size());
+        if (skippedCount > 0) {
+            msg += QString(tr("\n已完成跳过: %1")).arg(skippedCount);
+        }
 
         if (!failedInfos.isEmpty()) {
             msg += tr("\n\n[保存失败的文件]:\n");
@@ -893,7 +938,441 @@ void BarcodeWidget::onSaveClicked() {
         watcher->deleteLater();
     });
 
-    watcher->setFuture(QtConcurrent::mapped(tasks, worker{}));
+    watcher->setFuture(batch::BatchEngine<batch::SaveTask, batch::SaveResult>::run(
+        std::vector<batch::SaveTask>(tasks.begin(), tasks.end()),
+        batch::SaveWorker{sink, pngOptions(), std::move(journal)},
+        engineOptions()));
+}
+
+void BarcodeWidget::onMailMergeClicked() {
+    const QString tablePath =
+        QFileDialog::getOpenFileName(this, tr("选择表格"), QString(), tr("表格 (*.csv *.tsv *.xlsx)"));
+    if (tablePath.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    std::shared_ptr<io::TableReader> table = io::TableReader::open(tablePath, &error);
+    if (!table) {
+        QMessageBox::warning(this, tr("警告"), tr("无法读取表格: %1").arg(error));
+        return;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("表格批量生成"));
+    auto *form = new QFormLayout(&dialog);
+    auto *columnsLabel = new QLabel(table->header().join(", "), &dialog);
+    columnsLabel->setWordWrap(true);
+    auto *payloadEdit = new QLineEdit("{1}", &dialog);
+    auto *nameEdit = new QLineEdit("{row}", &dialog);
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    form->addRow(tr("表头:"), columnsLabel);
+    form->addRow(tr("条码内容:"), payloadEdit);
+    form->addRow(tr("文件名:"), nameEdit);
+    form->addRow(new QLabel(tr("用 {列名} 或 {列序号} 引用单元格，{row} 为数据行号"), &dialog));
+    form->addRow(buttons);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    auto payload = std::make_shared<const batch::RowTemplate>(payloadEdit->text(), table->header());
+    auto name = std::make_shared<const batch::RowTemplate>(nameEdit->text(), table->header());
+    const QStringList unknown = payload->unknownColumns() + name->unknownColumns();
+    if (!unknown.isEmpty()) {
+        const auto answer = QMessageBox::question(
+            this, tr("警告"), tr("表头中没有以下列，将替换为空:\n%1\n是否继续？").arg(unknown.join(", ")));
+        if (answer != QMessageBox::Yes) {
+            return;
+        }
+    }
+
+    auto sink = chooseBatchSink();
+    if (!sink) {
+        return;
+    }
+
+    updateImageSizeConfigFromUI();
+    const auto targetWidth = imageSizeConfig.getTargetWidthPixels();
+    const auto targetHeight = imageSizeConfig.getTargetHeightPixels();
+
+    // 输出到文件夹时按行记录任务日志，中断后对同一张表格重新生成只处理未完成的行
+    std::shared_ptr<batch::Journal> journal;
+    if (std::dynamic_pointer_cast<io::DirectorySink>(sink)) {
+        QString journalError;
+        journal = batch::Journal::open(sink->location(), &journalError);
+        if (!journal) {
+            spdlog::warn("Cannot open job journal, merging without it: {}", journalError.toStdString());
+        }
+    }
+
+    progressBar->setVisible(true);
+    progressBar->setRange(0, 0);
+    progressBar->setValue(0);
+    generateButton->setEnabled(false);
+    decodeToChemFile->setEnabled(false);
+    saveButton->setEnabled(false);
+    this->setCursor(Qt::WaitCursor);
+
+    auto *watcher = new QFutureWatcher<batch::SaveResult>(this);
+
+    attachProgress(watcher);
+
+    connect(watcher, &QFutureWatcher<batch::SaveResult>::finished, [this, watcher, sink, table]() {
+        this->setCursor(Qt::ArrowCursor);
+        progressBar->setVisible(false);
+        updateButtonStates();
+
+        // 成功的结果不带文件名，这里只统计数量并列出失败的行
+        const auto future = watcher->future();
+        const int total = future.resultCount();
+        int successCount = 0;
+        int skippedCount = 0;
+        QStringList failedInfos;
+        if (!sink->finish()) {
+            failedInfos.append(QString("• %1 (%2)").arg(QFileInfo(sink->location()).fileName(), sink->errorString()));
+        }
+        if (!table->errorString().isEmpty()) {
+            failedInfos.append(QString("• %1 (%2)").arg(tr("读取表格中断"), table->errorString()));
+        }
+        for (int i = 0; i < total; ++i) {
+            const auto res = future.resultAt(i);
+            if (res.err == batch::SaveResult::success) {
+                ++successCount;
+            } else if (res.err == batch::SaveResult::skipped) {
+                ++skippedCount;
+            } else {
+                QString reason = tr("写入失败");
+                if (res.err == batch::SaveResult::invalid_data) {
+                    reason = tr("生成失败");
+                } else if (res.err == batch::SaveResult::unverified) {
+                    reason = tr("校验失败");
+                }
+                failedInfos.append(QString("• %1 (%2)").arg(res.path, reason));
+            }
+        }
+
+        QString msg = QString(tr("操作完成。\n总计处理: %1\n成功: %2\n失败: %3"))
+                          .arg(total)
+                          .arg(successCount)
+                          .arg(failedInfos.size());
+        if (skippedCount > 0) {
+            msg += QString(tr("\n已完成跳过: %1")).arg(skippedCount);
+        }
+        if (failedInfos.isEmpty()) {
+            QMessageBox::information(this, tr("保存成功"), msg);
+        } else {
+            msg += tr("\n\n[保存失败的文件]:\n");
+            static constexpr int maxErrorsToShow = 10;
+            for (int i = 0; i < std::min(failedInfos.size(), maxErrorsToShow); ++i) {
+                msg += failedInfos[i] + "\n";
+            }
+            if (failedInfos.size() > maxErrorsToShow) {
+                msg += QString(tr("...以及其他 %1 个文件")).arg(failedInfos.size() - maxErrorsToShow);
+            }
+            QMessageBox::warning(this, tr("保存结果 - 包含错误"), msg);
+        }
+
+        watcher->deleteLater();
+    });
+
+    const batch::BatchEngine<batch::MergeRow, batch::SaveResult> engine(
+        batch::MergeWorker{{targetWidth,
+                            targetHeight,
+                            targetWidth,
+                            targetHeight,
+                            imageSizeConfig.ppi,
+                            base64CheckAcion->isChecked(),
+                            currentBarcodeFormat,
+                            memoryBudget,
+                            std::make_shared<io::ArchiveSet>(),
+                            outputFormat(),
+                            nullptr,
+                            verifyAction->isChecked()},
+                           sink,
+                           std::move(payload),
+                           pngOptions(),
+                           std::move(journal),
+                           generateSalt()},
+        engineOptions());
+    watcher->setFuture(engine.future());
+
+    // 表格在独立线程中逐行解析，引擎积压过多时等待，内存占用不随行数增长；
+    // 文件名在这里按行序展开并去重，重名的行追加的序号不受工作线程的完成顺序影响
+    auto *reader = QThread::create([engine, table, name = std::move(name), format = outputFormat()] {
+        static constexpr std::size_t batchRows = 512;
+        static constexpr std::size_t maxBacklog = 16384;
+        batch::UniqueNames names;
+        std::vector<batch::MergeRow> rows;
+        rows.reserve(batchRows);
+        QStringList cells;
+        while (table->next(cells)) {
+            const qint64 row = table->rowNumber();
+            QString dest = names.claim(batch::sanitizeOutputName(name->expand(cells, row), row, format));
+            rows.push_back({row, std::move(cells), std::move(dest)});
+            if (rows.size() < batchRows) {
+                continue;
+            }
+            if (!engine.waitForBacklog(maxBacklog)) {
+                rows.clear(); // 已取消
+                break;
+            }
+            engine.feed(std::exchange(rows, {}));
+            rows.reserve(batchRows);
+        }
+        if (!table->errorString().isEmpty()) {
+            spdlog::error("读取表格在第 {} 行后中断: {}", table->rowNumber(), table->errorString().toStdString());
+        }
+        engine.feed(std::move(rows));
+        engine.close();
+    });
+    connect(reader, &QThread::finished, reader, &QObject::deleteLater);
+    reader->start(QThread::LowPriority);
+}
+
+void BarcodeWidget::onPrintSheetClicked() {
+    auto labels = std::make_shared<std::vector<io::SheetLabel>>();
+    for (const auto &entry : lastResults) {
+        if (const auto *img = std::get_if<QImage>(&entry.data); img && !img->isNull()) {
+            labels->push_back({*img, QFileInfo(entry.source_file_name).fileName()});
+        }
+    }
+    if (labels->empty()) {
+        QMessageBox::warning(this, tr("警告"), tr("没有可打印的条码，请先生成条码。"));
+        return;
+    }
+
+    // 标签的物理尺寸与保存 PNG 时一致
+    updateImageSizeConfigFromUI();
+    io::SheetLayout layout;
+    layout.dpi = imageSizeConfig.ppi;
+    layout.labelSize = QSizeF(imageSizeConfig.getTargetWidthPixels() * 25.4 / imageSizeConfig.ppi,
+                              imageSizeConfig.getTargetHeightPixels() * 25.4 / imageSizeConfig.ppi);
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("打印排版"));
+    auto *form = new QFormLayout(&dialog);
+    auto *pageCombo = new QComboBox(&dialog);
+    pageCombo->addItem("A4", QPageSize::A4);
+    pageCombo->addItem("Letter", QPageSize::Letter);
+    pageCombo->addItem("A5", QPageSize::A5);
+    pageCombo->addItem("A3", QPageSize::A3);
+    const auto makeSpin = [&dialog](double value) {
+        auto *spin = new QDoubleSpinBox(&dialog);
+        spin->setRange(0, 100);
+        spin->setDecimals(1);
+        spin->setSuffix(" mm");
+        spin->setValue(value);
+        return spin;
+    };
+    auto *marginSpin = makeSpin(layout.margins.left());
+    auto *gapSpin = makeSpin(layout.gap);
+    auto *captionCheck = new QCheckBox(tr("在条码下方打印文件名"), &dialog);
+    captionCheck->setChecked(true);
+    auto *summaryLabel = new QLabel(&dialog);
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    form->addRow(tr("纸张:"), pageCombo);
+    form->addRow(tr("页边距:"), marginSpin);
+    form->addRow(tr("间距:"), gapSpin);
+    form->addRow(captionCheck);
+    form->addRow(summaryLabel);
+    form->addRow(buttons);
+
+    const double captionHeight = layout.captionHeight;
+    const auto updateLayout = [&] {
+        layout.pageSize = static_cast<QPageSize::PageSizeId>(pageCombo->currentData().toInt());
+        const double margin = marginSpin->value();
+        layout.margins = QMarginsF(margin, margin, margin, margin);
+        layout.gap = gapSpin->value();
+        layout.captionHeight = captionCheck->isChecked() ? captionHeight : 0;
+
+        const int perPage = layout.labelsPerPage();
+        buttons->button(QDialogButtonBox::Ok)->setEnabled(perPage > 0);
+        summaryLabel->setText(perPage > 0 ? tr("条码 %1 x %2 mm，每页 %3 个，共 %4 页")
+                                                .arg(layout.labelSize.width(), 0, 'f', 1)
+                                                .arg(layout.labelSize.height(), 0, 'f', 1)
+                                                .arg(perPage)
+                                                .arg(io::PrintSheetWriter(layout).pageCount(labels->size()))
+                                          : tr("条码尺寸超出纸张的可打印区域"));
+    };
+    connect(pageCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), &dialog, updateLayout);
+    connect(marginSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), &dialog, updateLayout);
+    connect(gapSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), &dialog, updateLayout);
+    connect(captionCheck, &QCheckBox::toggled, &dialog, updateLayout);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    updateLayout();
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    QString pdfPath = QFileDialog::getSaveFileName(
+        this,
+        tr("保存 PDF"),
+        QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).filePath("barcodes.pdf"),
+        "PDF Files (*.pdf)");
+    if (pdfPath.isEmpty()) {
+        return;
+    }
+    if (QFileInfo(pdfPath).suffix().isEmpty()) {
+        pdfPath += ".pdf";
+    }
+
+    generateButton->setEnabled(false);
+    decodeToChemFile->setEnabled(false);
+    saveButton->setEnabled(false);
+    this->setCursor(Qt::WaitCursor);
+
+    auto writer = std::make_shared<io::PrintSheetWriter>(layout, memoryBudget);
+    auto *progress = new QProgressDialog(tr("正在生成 PDF..."), tr("取消"), 0, writer->pageCount(labels->size()), this);
+    progress->setWindowTitle(tr("打印排版"));
+    progress->setMinimumDuration(0);
+    progress->setAutoReset(false);
+    progress->setAutoClose(false);
+    auto canceled = std::make_shared<std::atomic_bool>(false);
+    connect(progress, &QProgressDialog::canceled, this, [canceled] { canceled->store(true); });
+
+    // 页面在全局线程池中栅格化，排版与写入放在独立线程，不阻塞界面；对话框在线程结束后才释放
+    auto ok = std::make_shared<bool>(false);
+    auto *thread = QThread::create([writer, labels, pdfPath, ok, canceled, progress] {
+        *ok = writer->write(pdfPath, *labels, [progress, canceled](int done, int total) {
+            QMetaObject::invokeMethod(progress, [progress, done, total] {
+                progress->setMaximum(total);
+                progress->setValue(done);
+            });
+            return !canceled->load();
+        });
+    });
+    connect(thread, &QThread::finished, this, [this, thread, writer, ok, canceled, progress, pdfPath] {
+        thread->deleteLater();
+        progress->deleteLater();
+        this->setCursor(Qt::ArrowCursor);
+        updateButtonStates();
+        saveButton->setEnabled(true);
+        if (*ok) {
+            QMessageBox::information(this, tr("保存成功"), tr("已保存到 %1").arg(QDir::toNativeSeparators(pdfPath)));
+        } else if (!canceled->load()) {
+            QMessageBox::warning(this, tr("警告"), tr("无法生成 PDF: %1").arg(writer->errorString()));
+        }
+    });
+    progress->show();
+    thread->start();
+}
+
+void BarcodeWidget::startHotFolder() {
+    const auto uncheck = [this] {
+        const QSignalBlocker blocker(hotFolderAction);
+        hotFolderAction->setChecked(false);
+    };
+
+    const QString input = QFileDialog::getExistingDirectory(
+        this, tr("选择需要监视的文件夹"), QString(), QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (input.isEmpty()) {
+        uncheck();
+        return;
+    }
+    const QString output = QFileDialog::getExistingDirectory(
+        this, tr("选择输出文件夹"), input, QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (output.isEmpty()) {
+        uncheck();
+        return;
+    }
+    if (QDir(input) == QDir(output)) {
+        // 输出会再次被当作新文件处理，形成生成与解码的循环
+        QMessageBox::warning(this, tr("警告"), tr("输出文件夹不能与监视的文件夹相同"));
+        uncheck();
+        return;
+    }
+
+    // 参数在开始监视时确定，监视期间修改界面设置不影响正在运行的监视
+    updateImageSizeConfigFromUI();
+    const auto targetWidth = imageSizeConfig.getTargetWidthPixels();
+    const auto targetHeight = imageSizeConfig.getTargetHeightPixels();
+    const auto useBase64 = base64CheckAcion->isChecked();
+    const auto archives = std::make_shared<io::ArchiveSet>(); // 监视模式不展开归档，归档文件按普通文件生成条码
+    auto sink = std::make_shared<io::DirectorySink>(output);
+
+    // 任务日志放在输出文件夹中，重新开始监视时跳过上次已完成的文件
+    QString journalError;
+    auto journal = batch::Journal::open(output, &journalError);
+    if (!journal) {
+        QMessageBox::warning(this, tr("警告"), tr("无法打开任务日志，将重新处理所有文件: %1").arg(journalError));
+    }
+    const QByteArray salt = generateSalt();
+
+    auto options = engineOptions();
+    options.pool = &watchPool;
+    watchEngine.emplace(batch::WatchWorker{{targetWidth,
+                                            targetHeight,
+                                            targetWidth,
+                                            targetHeight,
+                                            imageSizeConfig.ppi,
+                                            useBase64,
+                                            currentBarcodeFormat,
+                                            memoryBudget,
+                                            archives,
+                                            outputFormat(),
+                                            nullptr,
+                                            verifyAction->isChecked()},
+                                           {useBase64, memoryBudget, archives},
+                                           std::move(sink),
+                                           std::move(journal),
+                                           salt,
+                                           pngOptions()},
+                        options);
+
+    auto *watcher = new QFutureWatcher<batch::SaveResult>(this);
+    auto counts = std::make_shared<std::array<int, 5>>(); // 按 SaveResult::errcode 计数
+    const auto showStatus = [this, input, output, counts] {
+        const auto &[success, invalid, failed, skipped, unverified] = *counts;
+        watchStatusLabel->setText(tr("正在监视 %1，输出到 %2\n已处理: %3，失败: %4，校验失败: %5，已完成跳过: %6")
+                                      .arg(QDir::toNativeSeparators(input), QDir::toNativeSeparators(output))
+                                      .arg(success)
+                                      .arg(invalid + failed)
+                                      .arg(unverified)
+                                      .arg(skipped));
+    };
+    connect(watcher, &QFutureWatcherBase::resultsReadyAt, this, [watcher, counts, showStatus](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            ++(*counts)[watcher->resultAt(i).err];
+        }
+        showStatus();
+    });
+    connect(watcher, &QFutureWatcherBase::finished, watcher, &QObject::deleteLater);
+    watcher->setFuture(watchEngine->future());
+
+    io::WatchOptions watchOptions;
+    watchOptions.debounce = std::chrono::milliseconds(batchConfig.watchDebounceMs);
+    watchOptions.settle = std::chrono::milliseconds(batchConfig.watchSettleMs);
+    watchOptions.rescanInterval = std::chrono::milliseconds(batchConfig.watchRescanMs);
+    hotFolder = new io::HotFolderWatcher(input, watchOptions, this);
+    connect(hotFolder, &io::HotFolderWatcher::filesReady, this, [engine = *watchEngine](const QStringList &paths) {
+        engine.feed(std::vector<QString>(paths.begin(), paths.end()));
+    });
+    if (!hotFolder->start()) {
+        stopHotFolder();
+        uncheck();
+        QMessageBox::warning(this, tr("警告"), tr("无法监视文件夹: %1").arg(input));
+        return;
+    }
+
+    showStatus();
+    watchStatusLabel->setVisible(true);
+}
+
+void BarcodeWidget::stopHotFolder() {
+    if (hotFolder) {
+        hotFolder->stop();
+        hotFolder->deleteLater();
+        hotFolder = nullptr;
+    }
+    if (watchEngine) {
+        // 已投递的文件处理完后引擎自行结束
+        watchEngine->close();
+        watchEngine.reset();
+    }
+    watchStatusLabel->setVisible(false);
 }
 
 void BarcodeWidget::showAbout() const {
@@ -941,7 +1420,8 @@ void BarcodeWidget::renderResults() const {
         return;
     }
 
-    constexpr int maxColumns = 4; // 每行最多4个 (仅用于多结果)
+    constexpr int maxColumns = 4;    // 每行最多4个 (仅用于多结果)
+    constexpr int maxRendered = 500; // 最多渲染的行数/结果数，超大批次只展示前面一部分
 
     if (lastResults.empty()) {
         if (!lastSelectedFiles.empty()) {
@@ -953,13 +1433,14 @@ void BarcodeWidget::renderResults() const {
             headerLabel->setObjectName("headerLabel");
             listLayout->addWidget(headerLabel);
 
-            for (const QString &filePath : lastSelectedFiles) {
+            for (const QString &filePath : lastSelectedFiles | std::views::take(maxRendered)) {
                 QFileInfo fi(filePath);
                 QString fileName = fi.fileName();
 
                 // 判断文件类型以决定图标和操作提示
                 bool isText = fileExtensionRegex_text.match(fileName).hasMatch();
                 bool isImage = fileExtensionRegex_image.match(fileName).hasMatch();
+                bool isDir = fi.isDir();
 
                 // 创建单行容器 Widget
                 QWidget *rowWidget = new QWidget();
@@ -994,7 +1475,10 @@ void BarcodeWidget::renderResults() const {
                 QLabel *typeLabel = new QLabel();
                 typeLabel->setObjectName("fileTypeLabel");
 
-                if (isImage) {
+                if (isDir) {
+                    typeLabel->setText(tr("[文件夹，递归处理]"));
+                    typeLabel->setProperty("status", "unknown");
+                } else if (isImage) {
                     typeLabel->setText(tr("[待解码]"));
                     typeLabel->setProperty("status", "decode");
                 } else if (isText) {
@@ -1012,6 +1496,12 @@ void BarcodeWidget::renderResults() const {
 
                 listLayout->addWidget(rowWidget);
             }
+            if (lastSelectedFiles.size() > maxRendered) {
+                QLabel *moreLabel =
+                    new QLabel(QString(tr("...以及其他 %1 个文件")).arg(lastSelectedFiles.size() - maxRendered));
+                moreLabel->setObjectName("headerLabel");
+                listLayout->addWidget(moreLabel);
+            }
             // 底部弹簧，确保列表靠上
             listLayout->addStretch();
 
@@ -1082,7 +1572,7 @@ void BarcodeWidget::renderResults() const {
 
         int count = 0;
 
-        for (const auto &entry : lastResults) {
+        for (const auto &entry : lastResults | std::views::take(maxRendered)) {
             int row = count / maxColumns;
             int col = count % maxColumns;
 
@@ -1141,6 +1631,10 @@ void BarcodeWidget::renderResults() const {
                     fileNameStr = "Unknown";
                 }
 
+                if (entry.verified == convert::verify_status::failed) {
+                    fileNameStr.prepend(tr("[校验失败] "));
+                }
+
                 QLabel *nameLabel = new QLabel(fileNameStr);
                 nameLabel->setObjectName("resultNameLabel");
                 nameLabel->setAlignment(Qt::AlignCenter);
@@ -1159,6 +1653,12 @@ void BarcodeWidget::renderResults() const {
             }
             count++;
         }
+        if (lastResults.size() > static_cast<std::size_t>(maxRendered)) {
+            QLabel *moreLabel = new QLabel(
+                QString(tr("仅展示前 %1 个结果，共 %2 个，保存时全部写出")).arg(maxRendered).arg(lastResults.size()));
+            moreLabel->setObjectName("resultNameLabel");
+            gridLayout->addWidget(moreLabel, count / maxColumns + 1, 0, 1, maxColumns, Qt::AlignCenter);
+        }
     }
 
     scrollArea->setWidget(container);
@@ -1166,7 +1666,7 @@ void BarcodeWidget::renderResults() const {
 
 void BarcodeWidget::onBatchFinish(QFutureWatcher<convert::result_data_entry> &watcher) {
     setCursor(Qt::ArrowCursor);
-    if (lastSelectedFiles.size() == 1) {
+    if (lastSelectedFiles.size() == 1 && !io::ArchiveReader::isArchivePath(lastSelectedFiles.front())) {
         auto &file = lastSelectedFiles.front();
         bool isImage = fileExtensionRegex_image.match(file).hasMatch();
         generateButton->setEnabled(!isImage);
@@ -1182,18 +1682,54 @@ void BarcodeWidget::onBatchFinish(QFutureWatcher<convert::result_data_entry> &wa
 
     lastResults.clear();
     lastResults.reserve(results.size());
+    int completedCount = 0; // 任务日志中已完成、未重新生成的文件不参与展示和保存
     for (auto &item : results) {
-        lastResults.push_back(std::move(item));
+        if (item.completed) {
+            ++completedCount;
+        } else {
+            lastResults.push_back(std::move(item));
+        }
     }
 
     if (!lastResults.empty()) {
         saveButton->setEnabled(true);
         renderResults(); // 批量渲染结果
+        reportVerifyFailures();
+    } else if (completedCount == 0) {
+        // 文件夹模式下可能遍历完才发现没有可处理的文件
+        QMessageBox::warning(this, tr("警告"), tr("无可处理文件"));
+    }
+    if (completedCount > 0) {
+        QMessageBox::information(
+            this, tr("提示"), QString(tr("输出文件夹中已有 %1 个文件的完整输出，已跳过")).arg(completedCount));
     }
 
     watcher.deleteLater();
 }
 
+void BarcodeWidget::reportVerifyFailures() {
+    QStringList failed;
+    for (const auto &entry : lastResults) {
+        if (entry.verified == convert::verify_status::failed) {
+            failed.append(entry.source_file_name);
+        }
+    }
+    if (failed.isEmpty()) {
+        return;
+    }
+
+    QString msg = QString(tr("%1 个生成结果无法解码或内容不一致，可能是尺寸过小导致模块模糊。")).arg(failed.size());
+    msg += tr("\n\n[校验失败的文件]:\n");
+    static constexpr int maxToShow = 10;
+    for (const auto &path : failed | std::views::take(maxToShow)) {
+        msg += "• " + QFileInfo(path).fileName() + "\n";
+    }
+    if (failed.size() > maxToShow) {
+        msg += QString(tr("...以及其他 %1 个文件")).arg(failed.size() - maxToShow);
+    }
+    QMessageBox::warning(this, tr("校验失败"), msg);
+}
+
 template <>
 struct magic_enum::customize::enum_range<ZXing::BarcodeFormat> {
     static constexpr bool is_flags = true;
@@ -1260,11 +1796,20 @@ void BarcodeWidget::retranslate() {
     toolsMenu->setTitle(tr("工具"));
     settingMenu->setTitle(tr("设置"));
     languageSubMenu->setTitle(tr("语言"));
+    outputFormatSubMenu->setTitle(tr("保存格式"));
+    outputProfilesAction->setText(tr("按输出配置生成多份"));
     aboutAction->setText(tr("关于软件"));
     debugMqttAction->setText(tr("MQTT实时消息监控窗口"));
     openCameraScanAction->setText(tr("打开摄像头扫码"));
     base64CheckAcion->setText(tr("Base64"));
     directTextAction->setText(tr("文本输入"));
+    archiveOutputAction->setText(tr("批量保存为归档"));
+    folderModeAction->setText(tr("文件夹模式"));
+    verifyAction->setText(tr("生成后校验"));
+    resumeAction->setText(tr("批量生成时跳过已完成的文件"));
+    hotFolderAction->setText(tr("监视文件夹"));
+    mailMergeAction->setText(tr("表格批量生成"));
+    printSheetAction->setText(tr("打印排版 (PDF)"));
     filePathEdit->setPlaceholderText(tr("选择一个文件或图片"));
     browseButton->setText(tr("浏览"));
     generateButton->setText(tr("生成"));
@@ -1317,4 +1862,176 @@ void BarcodeWidget::updateImageSizeConfigFromUI() {
 void BarcodeWidget::saveImageSizeConfig() {
     updateImageSizeConfigFromUI();
     ImageSizeConfig::saveToConfig("./setting/config.json", imageSizeConfig);
-}
\ No newline at end of file
+}
+
+convert::output_format BarcodeWidget::outputFormat() const {
+    const auto *action = outputFormatGroup->checkedAction();
+    return action ? static_cast<convert::output_format>(action->data().toInt()) : convert::output_format::png;
+}
+
+QByteArray BarcodeWidget::generateSalt(const std::vector<batch::RenderProfile> *profiles) const {
+    QString salt = QString("%1x%2@%3|%4|%5|%6")
+                       .arg(imageSizeConfig.getTargetWidthPixels())
+                       .arg(imageSizeConfig.getTargetHeightPixels())
+                       .arg(imageSizeConfig.ppi)
+                       .arg(barcodeFormatToString(currentBarcodeFormat))
+                       .arg(base64CheckAcion->isChecked())
+                       .arg(static_cast<int>(outputFormat()));
+    if (profiles) {
+        for (const auto &profile : *profiles) {
+            salt += QString("|%1:%2x%3@%4:%5")
+                        .arg(profile.name)
+                        .arg(profile.width)
+                        .arg(profile.height)
+                        .arg(profile.ppi)
+                        .arg(static_cast<int>(profile.format));
+        }
+    }
+    return salt.toUtf8();
+}
+
+batch::EngineOptions BarcodeWidget::engineOptions() const {
+    batch::EngineOptions options;
+    options.targetChunkTime = std::chrono::milliseconds(batchConfig.chunkTargetMs);
+    options.maxChunkSize = batchConfig.maxChunkSize;
+    options.progressInterval = std::chrono::milliseconds(batchConfig.progressIntervalMs);
+    return options;
+}
+
+io::PngOptions BarcodeWidget::pngOptions() const {
+    return {batchConfig.pngCompressionLevel, batchConfig.pngFilter};
+}
+
+std::shared_ptr<const std::vector<batch::RenderProfile>> BarcodeWidget::renderProfiles() const {
+    if (!outputProfilesAction->isChecked() || outputProfiles.empty()) {
+        return nullptr;
+    }
+    auto profiles = std::make_shared<std::vector<batch::RenderProfile>>();
+    profiles->reserve(outputProfiles.size());
+    for (const auto &config : outputProfiles) {
+        profiles->push_back({QString::fromStdString(config.name),
+                             config.size.getTargetWidthPixels(),
+                             config.size.getTargetHeightPixels(),
+                             config.size.ppi,
+                             magic_enum::enum_cast<convert::output_format>(config.format)
+                                 .value_or(convert::output_format::png)});
+    }
+    return profiles;
+}
+
+std::shared_ptr<io::OutputSink> BarcodeWidget::chooseBatchSink() {
+    if (!archiveOutputAction->isChecked()) {
+        const QString dir =
+            QFileDialog::getExistingDirectory(this,
+                                              tr("请选择保存文件夹"),
+                                              QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+                                              QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+        if (dir.isEmpty()) {
+            return nullptr;
+        }
+        return std::make_shared<io::DirectorySink>(dir);
+    }
+
+    // 整批写入单个归档，避免成千上万个小文件
+    QString selectedFilter;
+    QString archivePath = QFileDialog::getSaveFileName(
+        this,
+        tr("保存归档"),
+        QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).filePath("barcodes.zip"),
+        "ZIP Archives (*.zip);;TAR Archives (*.tar)",
+        &selectedFilter);
+
+    if (archivePath.isEmpty()) {
+        return nullptr;
+    }
+    if (!io::ArchiveSink::formatFromPath(archivePath)) {
+        archivePath += selectedFilter.contains("tar") ? ".tar" : ".zip";
+    }
+
+    QString error;
+    auto sink = io::ArchiveSink::create(archivePath, &error);
+    if (!sink) {
+        QMessageBox::warning(this, tr("警告"), tr("无法创建归档文件: %1").arg(error));
+    }
+    return sink;
+}
+
+QStringList BarcodeWidget::expandSelectedFiles(io::ArchiveSet &archives, QStringList &folders) {
+    QStringList files;
+    for (const auto &path : lastSelectedFiles) {
+        if (QFileInfo(path).isDir()) {
+            folders.append(path);
+        } else {
+            files.append(path);
+        }
+    }
+
+    QStringList errors;
+    QStringList inputs = archives.expand(files, &errors);
+    if (!errors.isEmpty()) {
+        QMessageBox::warning(this, tr("警告"), tr("以下归档无法打开，已跳过:\n%1").arg(errors.join("\n")));
+    }
+    return inputs;
+}
+
+void BarcodeWidget::streamFolders(const batch::BatchEngine<QString, convert::result_data_entry> &engine,
+                                  const std::shared_ptr<io::ArchiveSet> &archives,
+                                  const QStringList &folders,
+                                  io::InputKind kind) const {
+    if (folders.isEmpty()) {
+        engine.close();
+        return;
+    }
+
+    // 遍历放在独立线程：全局线程池已被引擎的工作线程占满，且百万级目录不能阻塞界面
+    auto *walker = QThread::create([engine, archives, folders, kind] {
+        const auto future = engine.future();
+        const auto expand = [&](std::vector<QString> &&batch) {
+            std::vector<QString> files;
+            files.reserve(batch.size());
+            for (auto &path : batch) {
+                if (!io::ArchiveReader::isArchivePath(path)) {
+                    files.push_back(std::move(path));
+                    continue;
+                }
+                // 文件夹中的归档与直接选中的一样展开为条目，只投递需要的类型
+                QStringList errors;
+                for (const auto &entry : archives->expand({path}, &errors)) {
+                    if (io::classifyInput(entry) == kind) {
+                        files.push_back(entry);
+                    }
+                }
+                for (const auto &error : errors) {
+                    spdlog::warn("Skipping archive in folder: {}", error.toStdString());
+                }
+            }
+            return files;
+        };
+        for (const auto &folder : folders) {
+            io::walkDirectory(
+                folder,
+                kind,
+                [&](std::vector<QString> &&batch) {
+                    if (future.isCanceled()) {
+                        return false;
+                    }
+                    engine.feed(expand(std::move(batch)));
+                    return true;
+                },
+                {.includeArchives = true});
+        }
+        engine.close();
+    });
+    connect(walker, &QThread::finished, walker, &QObject::deleteLater);
+    walker->start(QThread::LowPriority);
+}
+
+void BarcodeWidget::attachProgress(QFutureWatcherBase *watcher) const {
+    // 进度由批处理引擎按固定频率上报，这里只负责显示
+    connect(watcher, &QFutureWatcherBase::progressRangeChanged, progressBar, &QProgressBar::setRange);
+    connect(watcher, &QFutureWatcherBase::progressValueChanged, progressBar, &QProgressBar::setValue);
+    connect(watcher, &QFutureWatcherBase::progressTextChanged, progressBar, [this](const QString &text) {
+        progressBar->setFormat(text.isEmpty() ? QStringLiteral("%p%") : QStringLiteral("%p%  ") + text);
+    });
+    connect(watcher, &QFutureWatcherBase::finished, progressBar, [this] { progressBar->resetFormat(); });
+}
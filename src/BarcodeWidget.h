@@ -1,15 +1,23 @@
 #pragma once
 
+#include <optional>
 #include <vector>
 
+#include <QThreadPool>
 #include <QWidget>
 #include <ZXing/BarcodeFormat.h>
 #include <opencv2/opencv.hpp>
 #include <qfuturewatcher.h>
 
 #include "CameraWidget.h"
+#include "batch/BatchEngine.h"
+#include "batch/MemoryBudget.h"
+#include "batch/Workers.h"
+#include "components/BatchConfig.h"
 #include "components/ImageSizeConfig.h"
+#include "components/OutputProfileConfig.h"
 #include "convert.h"
+#include "io/DirectoryWalker.h"
 #include "mqtt/MQTTMessageWidget.h"
 #include "mqtt/mqtt_client.h"
 
@@ -22,6 +30,13 @@ class QComboBox;
 class QFileDialog;
 class QProgressBar;
 class QMenuBar;
+class QActionGroup;
+
+namespace io {
+class ArchiveSet;
+class HotFolderWatcher;
+class OutputSink;
+} // namespace io
 
 /**
  * @class BarcodeWidget
@@ -40,6 +55,8 @@ public:
      */
     explicit BarcodeWidget(QWidget *parent = nullptr);
 
+    ~BarcodeWidget() override;
+
 private:
     static const QStringList barcodeFormats;
 
@@ -81,6 +98,26 @@ private slots:
      */
     void onSaveClicked();
 
+    /**
+     * @brief 表格批量生成：选择 CSV/XLSX 表格，按模板把每行展开为条码内容和文件名，边读取边生成并写入输出目标
+     */
+    void onMailMergeClicked();
+
+    /**
+     * @brief 打印排版：把当前生成的条码按实际物理尺寸排到多页 PDF 中，每个条码下方附文件名
+     */
+    void onPrintSheetClicked();
+
+    /**
+     * @brief 开始监视文件夹：依次选择监视的文件夹和输出文件夹，新文件自动生成或解码并写入输出文件夹
+     */
+    void startHotFolder();
+
+    /**
+     * @brief 停止监视文件夹，已投递的文件继续处理完
+     */
+    void stopHotFolder();
+
     /**
      * @brief 显示关于软件的信息对话框。
      */
@@ -149,44 +186,129 @@ private:
      */
     void updateImageSizeConfigFromUI();
 
+    /**
+     * @brief 根据批处理配置生成批处理引擎参数
+     */
+    batch::EngineOptions engineOptions() const;
+
+    /**
+     * @brief 根据批处理配置生成 PNG 编码参数
+     */
+    io::PngOptions pngOptions() const;
+
+    /**
+     * @brief 生成完成后汇总校验失败的结果
+     */
+    void reportVerifyFailures();
+
+    /**
+     * @brief 启用多份输出时返回各输出配置的目标尺寸和格式，否则返回空
+     */
+    std::shared_ptr<const std::vector<batch::RenderProfile>> renderProfiles() const;
+
+    /**
+     * @brief 当前选择的条码保存格式
+     */
+    convert::output_format outputFormat() const;
+
+    /**
+     * @brief 生成参数（尺寸、格式、Base64、保存格式及输出配置）的摘要，任务日志以此区分参数不同的输出
+     *
+     * 调用前先 updateImageSizeConfigFromUI()。
+     * @param profiles 多份输出时的输出配置，可为空
+     */
+    QByteArray generateSalt(const std::vector<batch::RenderProfile> *profiles = nullptr) const;
+
+    /**
+     * @brief 选择批量输出的目标：勾选了批量保存为归档时选择归档文件，否则选择文件夹
+     * @return 用户取消或无法创建归档时返回 nullptr
+     */
+    std::shared_ptr<io::OutputSink> chooseBatchSink();
+
+    /**
+     * @brief 将选中的 ZIP/TAR 归档展开为其中的条目，无法打开的归档弹窗提示
+     * @param archives 保存打开的归档，供工作线程读取条目
+     * @param folders 输出选中的文件夹，由 streamFolders 在后台遍历
+     * @return 展开后的文件路径（不含文件夹）
+     */
+    QStringList expandSelectedFiles(io::ArchiveSet &archives, QStringList &folders);
+
+    /**
+     * @brief 在独立线程中递归遍历文件夹，边遍历边向批处理引擎投递，遍历结束后关闭引擎
+     *
+     * 文件夹中的 ZIP/TAR 归档与直接选中的归档一样展开为其中的条目。
+     * @param engine 批处理引擎
+     * @param archives 遇到的归档加入其中，供工作线程读取条目
+     * @param folders 需要遍历的文件夹，为空时直接关闭引擎
+     * @param kind 需要投递的文件类型
+     */
+    void streamFolders(const batch::BatchEngine<QString, convert::result_data_entry> &engine,
+                       const std::shared_ptr<io::ArchiveSet> &archives,
+                       const QStringList &folders,
+                       io::InputKind kind) const;
+
+    /**
+     * @brief 将异步任务的进度、剩余时间绑定到进度条
+     * @param watcher 异步任务监视器
+     */
+    void attachProgress(QFutureWatcherBase *watcher) const;
+
 private:
     QStringList lastSelectedFiles; /**< 上次选择的文件路径列表 */
 
-    QMenuBar *menuBar;      /**< 主菜单栏 */
-    QMenu *helpMenu;        /**< 帮助菜单 */
-    QMenu *toolsMenu;       /**< 工具菜单 */
-    QMenu *settingMenu;     /**< 设置菜单 */
-    QMenu *languageSubMenu; /**< 语言菜单 */
-
-    QAction *aboutAction;          /**< "关于"操作 */
-    QAction *debugMqttAction;      /**< 打开MQTT消息展示窗口 */
-    QAction *openCameraScanAction; /**< 启动摄像头扫描条码 */
-    QAction *base64CheckAcion;     /**< 启用Base64编码/解码 */
-    QAction *directTextAction;     /**< 启用文本输入*/
-
-    QLineEdit *filePathEdit;                                                  /**< 文件路径输入框 */
-    QPushButton *browseButton;                                                /**< 浏览按钮 */
-    QPushButton *generateButton;                                              /**< 生成条码按钮 */
-    QPushButton *decodeToChemFile;                                            /**< 解码并保存为化验文件 */
-    QPushButton *saveButton;                                                  /**< 保存条码图片按钮 */
-    QLabel *emptyLabel;                                                       /**< 图片展示区域空白时标签 */
-    QLabel *formatLabel;                                                      /**< 选择条码类型标签 */
-    QLabel *widthLabel;                                                       /**< 宽度标签 */
-    QLabel *heightLabel;                                                      /**< 高度标签 */
-    QLabel *unitLabel;                                                        /**< 单位标签 */
-    QLabel *ppiLabel;                                                         /**< PPI标签 */
-    QProgressBar *progressBar;                                                /**< 异步进度条 */
-    std::vector<convert::result_data_entry> lastResults;                      /**< 上次解码结果 */
-    QScrollArea *scrollArea;                                                  /**< 滚动区域 */
-    QComboBox *formatComboBox;                                                /**< 条码格式选择框 */
-    ZXing::BarcodeFormat currentBarcodeFormat = ZXing::BarcodeFormat::QRCode; /**< 当前选择的条码格式 */
-    QLineEdit *widthInput;                                                    /**< 图片宽度输入框 */
-    QLineEdit *heightInput;                                                   /**< 图片高度输入框 */
-    QComboBox *unitComboBox;                                                  /**< 单位选择框 */
-    QLineEdit *ppiInput;                                                      /**< PPI输入框 */
-    QFileDialog *fileDialog;                                                  /**< 文件选择对话框 */
-    std::unique_ptr<MqttSubscriber> subscriber_;                              /**< MQTT订阅者实例 */
-    std::unique_ptr<MQTTMessageWidget> messageWidget;                         /**< MQTT消息展示窗口 */
-    CameraWidget preview;                                                     /**< 摄像头预览窗口 */
-    ImageSizeConfig imageSizeConfig;                                          /**< 图像尺寸配置 */
+    QMenuBar *menuBar;          /**< 主菜单栏 */
+    QMenu *helpMenu;            /**< 帮助菜单 */
+    QMenu *toolsMenu;           /**< 工具菜单 */
+    QMenu *settingMenu;         /**< 设置菜单 */
+    QMenu *languageSubMenu;     /**< 语言菜单 */
+    QMenu *outputFormatSubMenu; /**< 生成条码的保存格式菜单 */
+
+    QAction *aboutAction;            /**< "关于"操作 */
+    QAction *debugMqttAction;        /**< 打开MQTT消息展示窗口 */
+    QAction *openCameraScanAction;   /**< 启动摄像头扫描条码 */
+    QAction *base64CheckAcion;       /**< 启用Base64编码/解码 */
+    QAction *directTextAction;       /**< 启用文本输入*/
+    QAction *archiveOutputAction;    /**< 批量保存为单个 ZIP/TAR 归档 */
+    QAction *folderModeAction;       /**< 浏览时选择文件夹并递归处理 */
+    QAction *hotFolderAction;        /**< 监视文件夹，自动处理新文件 */
+    QAction *mailMergeAction;        /**< 从 CSV/XLSX 表格批量生成 */
+    QAction *printSheetAction;       /**< 将生成的条码排版为可打印的 PDF */
+    QActionGroup *outputFormatGroup; /**< 保存格式 PNG/SVG/PDF，data 为 convert::output_format */
+    QAction *outputProfilesAction;   /**< 按配置文件中的多个输出配置生成 */
+    QAction *verifyAction;           /**< 生成后解码校验每张图片 */
+    QAction *resumeAction;           /**< 批量生成前选择输出文件夹，跳过其任务日志中已完成的文件 */
+
+    QLineEdit *filePathEdit;                                                   /**< 文件路径输入框 */
+    QPushButton *browseButton;                                                 /**< 浏览按钮 */
+    QPushButton *generateButton;                                               /**< 生成条码按钮 */
+    QPushButton *decodeToChemFile;                                             /**< 解码并保存为化验文件 */
+    QPushButton *saveButton;                                                   /**< 保存条码图片按钮 */
+    QLabel *emptyLabel;                                                        /**< 图片展示区域空白时标签 */
+    QLabel *formatLabel;                                                       /**< 选择条码类型标签 */
+    QLabel *widthLabel;                                                        /**< 宽度标签 */
+    QLabel *heightLabel;                                                       /**< 高度标签 */
+    QLabel *unitLabel;                                                         /**< 单位标签 */
+    QLabel *ppiLabel;                                                          /**< PPI标签 */
+    QProgressBar *progressBar;                                                 /**< 异步进度条 */
+    QLabel *watchStatusLabel;                                                  /**< 监视文件夹的状态 */
+    std::vector<convert::result_data_entry> lastResults;                       /**< 上次解码结果 */
+    std::shared_ptr<batch::Journal> batchJournal;                              /**< 续做批量生成的任务日志 */
+    QScrollArea *scrollArea;                                                   /**< 滚动区域 */
+    QComboBox *formatComboBox;                                                 /**< 条码格式选择框 */
+    ZXing::BarcodeFormat currentBarcodeFormat = ZXing::BarcodeFormat::QRCode;  /**< 当前选择的条码格式 */
+    QLineEdit *widthInput;                                                     /**< 图片宽度输入框 */
+    QLineEdit *heightInput;                                                    /**< 图片高度输入框 */
+    QComboBox *unitComboBox;                                                   /**< 单位选择框 */
+    QLineEdit *ppiInput;                                                       /**< PPI输入框 */
+    QFileDialog *fileDialog;                                                   /**< 文件选择对话框 */
+    std::unique_ptr<MqttSubscriber> subscriber_;                               /**< MQTT订阅者实例 */
+    std::unique_ptr<MQTTMessageWidget> messageWidget;                          /**< MQTT消息展示窗口 */
+    CameraWidget preview;                                                      /**< 摄像头预览窗口 */
+    ImageSizeConfig imageSizeConfig;                                           /**< 图像尺寸配置 */
+    BatchConfig batchConfig;                                                   /**< 批处理配置 */
+    std::vector<OutputProfileConfig> outputProfiles;                           /**< 配置文件中的输出配置 */
+    std::shared_ptr<batch::MemoryBudget> memoryBudget;                         /**< 批处理在途内存预算 */
+    QThreadPool watchPool;                                                     /**< 监视文件夹专用线程池 */
+    io::HotFolderWatcher *hotFolder = nullptr;                                 /**< 当前监视的文件夹 */
+    std::optional<batch::BatchEngine<QString, batch::SaveResult>> watchEngine; /**< 监视文件夹的常驻批处理引擎 */
 };
@@ -1,8 +1,8 @@
 #include "CameraWidget.h"
+#include "components/BatchConfig.h"
 #include "components/UiConfig.h"
 #include "components/beep.h"
 #include "sysinfo.h"
-#include <QBuffer>
 #include <QCameraInfo>
 #include <QComboBox>
 #include <QDateTime>
@@ -19,10 +19,13 @@
 #include <QStandardItemModel>
 #include <QStandardPaths>
 #include <QTableView>
+#include <QThreadPool>
 #include <QTimer>
 #include <QToolButton>
 #include <QWidgetAction>
+#include <QtConcurrent>
 #include <ZXing/ReadBarcode.h>
+#include <algorithm>
 #include <filesystem>
 #include <magic_enum/magic_enum_format.hpp>
 #include <qaction.h>
@@ -31,10 +34,15 @@
 #include <xlsxwriter.h>
 
 static constexpr auto HISTOGRAM_CLIP_THRESHOLD = 0.1;
+static constexpr auto DUPLICATE_WINDOW = std::chrono::seconds(3); // 条码离开画面超过该时间后才可能再次记录
 
 // 类静态成员变量初始化
 QString CameraWidget::lastContent = "";
 QString CameraWidget::lastType = "";
+CameraWidget::RecentCodes CameraWidget::recentCodes;
+std::vector<CameraWidget::RecentCodes::key_type> CameraWidget::visibleCodes;
+std::uint64_t CameraWidget::visibleSequence = 0;
+std::mutex CameraWidget::lastMutex;
 
 static const std::vector<std::pair<ZXing::BarcodeFormat, QString>> kBarcodeFormatList{
     {ZXing::BarcodeFormat::Aztec,           "Aztec"          },
@@ -80,31 +88,125 @@ static ZXing::ImageView ImageViewFromMat(const cv::Mat &image) {
     return {image.data, image.cols, image.rows, fmt};
 }
 
+/**
+ * @brief 按像素排列取原始帧的亮度，YUV 帧不复制数据
+ * @param frame 摄像头输出的原始帧
+ * @param layout 原始帧的像素排列
+ * @return 转换后的 ZXing::ImageView 对象
+ */
+static ZXing::ImageView ImageViewFromFrame(const cv::Mat &frame, camera::PixelLayout layout) {
+    using camera::PixelLayout;
+    using ZXing::ImageFormat;
+    const auto step = static_cast<int>(frame.step);
+    const auto height = camera::FrameConverter::imageSize(frame, layout).height;
+    switch (layout) {
+    // 打包格式的亮度每隔一个字节出现一次，按像素步长 2 读取
+    case PixelLayout::YUYV: return {frame.data, frame.cols, frame.rows, ImageFormat::Lum, step, 2};
+    case PixelLayout::UYVY: return {frame.data + 1, frame.cols, frame.rows, ImageFormat::Lum, step, 2};
+    case PixelLayout::NV12:
+    case PixelLayout::NV21: return {frame.data, frame.cols, height, ImageFormat::Lum, step};
+    default: return ImageViewFromMat(frame);
+    }
+}
+
+/**
+ * @brief 条码在整帧中的四个角点
+ *
+ * @param bc 条码对象，位置相对于解码时的图像
+ * @param offset 解码图像左上角在整帧中的位置，在区域内解码时不为零
+ * @param scale 解码图像相对整帧的缩小倍数，在缩小的图像上解码时大于 1
+ */
+static std::array<cv::Point, 4> CornersOf(const ZXing::Barcode &bc, cv::Point offset, int scale = 1) {
+    const auto pos = bc.position();
+    const auto cvp = [offset, scale](ZXing::PointI p) { return cv::Point(p.x, p.y) * scale + offset; };
+    return {cvp(pos[0]), cvp(pos[1]), cvp(pos[2]), cvp(pos[3])};
+}
+
 /**
  * @brief 在图像上绘制条码的边界框和文本
  *
  * @param img 输入输出图像，绘制条形码的边界框和文本
- * @param bc 条码对象，包含条码的位置信息和识别的文本
+ * @param overlay 条码的位置信息和识别的文本
  */
-static void DrawBarcode(cv::Mat &img, const ZXing::Barcode &bc) {
-    const auto pos = bc.position();
-    const auto cvp = [](ZXing::PointI p) { return cv::Point(p.x, p.y); };
-    const std::vector<cv::Point> pts = {cvp(pos[0]), cvp(pos[1]), cvp(pos[2]), cvp(pos[3])};
+static void DrawBarcode(cv::Mat &img, const BarcodeOverlay &overlay) {
+    const std::vector<cv::Point> pts(overlay.corners.begin(), overlay.corners.end());
     cv::polylines(img, pts, true, CV_RGB(0, 255, 0));
-    cv::putText(img, bc.text(), cvp(pos[3]) + cv::Point(0, 20), cv::FONT_HERSHEY_DUPLEX, 0.5, CV_RGB(0, 255, 0));
+    cv::putText(img,
+                overlay.text.toStdString(),
+                overlay.corners[3] + cv::Point(0, 20),
+                cv::FONT_HERSHEY_DUPLEX,
+                0.5,
+                CV_RGB(0, 255, 0));
+}
+
+/**
+ * @brief 解码线程数：留一个核给采集与界面，其余用于解码，线程再多只会让更多旧帧排队
+ */
+static int DecodeThreadCount() {
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(cores - 1, 1, 8);
+}
+
+/**
+ * @brief 按条码族并行解码专用的线程池，解码线程提交一维码的搜索后自己继续搜索二维码
+ */
+static QThreadPool &FamilyPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+/**
+ * @brief 解码一幅图像，一维码与二维码都在搜索范围内时分成两族同时搜索
+ *
+ * 单次 ReadBarcodes 会依次搜索一维码与二维码，两族互不依赖，拆开后单帧的延迟取决于较慢的一族。
+ * 结果按位置从上到下、从左到右排列，与哪一族先完成无关。
+ * @param view 输入图像
+ * @param options 解码参数，格式为空表示全部格式
+ * @param parallel 是否拆分条码族并行解码
+ */
+static ZXing::Barcodes ReadBarcodesByFamily(const ZXing::ImageView &view,
+                                            const ZXing::ReaderOptions &options,
+                                            bool parallel) {
+    ZXing::BarcodeFormats formats = options.formats();
+    if (formats.empty()) {
+        formats = ZXing::BarcodeFormat::Any;
+    }
+    const auto linear = formats & ZXing::BarcodeFormat::LinearCodes;
+    const auto matrix = formats & ZXing::BarcodeFormat::MatrixCodes;
+    if (!parallel || linear.empty() || matrix.empty()) {
+        return ZXing::ReadBarcodes(view, options);
+    }
+
+    auto linearOptions = options;
+    linearOptions.setFormats(linear);
+    auto matrixOptions = options;
+    matrixOptions.setFormats(matrix);
+    // view 引用的帧在等待结果期间一直有效
+    auto linearFuture =
+        QtConcurrent::run(&FamilyPool(), [view, linearOptions] { return ZXing::ReadBarcodes(view, linearOptions); });
+    auto barcodes = ZXing::ReadBarcodes(view, matrixOptions);
+    for (auto &bc : linearFuture.result()) {
+        barcodes.push_back(std::move(bc));
+    }
+
+    // 按位置合并两族的结果
+    std::ranges::sort(barcodes, {}, [](const ZXing::Barcode &bc) {
+        const auto pos = bc.position();
+        return std::pair(pos[0].y + pos[1].y + pos[2].y + pos[3].y, pos[0].x + pos[1].x + pos[2].x + pos[3].x);
+    });
+    return barcodes;
 }
 
 /**
  * @brief 将多边形区域修正为矩形图片
  *        为了不裁剪到条码，增加了一定的边距
  * @param img 原始图像
- * @param bc 条码对象，包含条码的位置信息和识别的文本
+ * @param corners 条码的四个角点
  * @param enhance 是否对结果进行图像增强
  *                如果为 true，则对修正后的图像进行增强处理（对比度拉伸与亮度非线性映射），以提高条码的可读性。
- * @return 修正后的矩形图片
+ * @return 修正后的矩形图片，通道数与输入相同（BGRA 输入转换为 BGR）
  */
-cv::Mat RectifyPolygonToRect(const cv::Mat &img, const ZXing::Barcode &bc, bool enhance) {
-    const auto corners = bc.position();
+cv::Mat RectifyPolygonToRect(const cv::Mat &img, const std::array<cv::Point, 4> &corners, bool enhance) {
     const std::vector<cv::Point2f> barcodeCorners = {
         cv::Point2f(corners[0].x, corners[0].y),
         cv::Point2f(corners[1].x, corners[1].y),
@@ -149,21 +251,19 @@ cv::Mat RectifyPolygonToRect(const cv::Mat &img, const ZXing::Barcode &bc, bool
         return rectifiedImage;
     }
 
-    if (rectifiedImage.channels() == 1) {
-        cv::cvtColor(rectifiedImage, rectifiedImage, cv::COLOR_GRAY2BGR);
-    } else if (rectifiedImage.channels() == 4) {
+    if (rectifiedImage.channels() == 4) {
         cv::cvtColor(rectifiedImage, rectifiedImage, cv::COLOR_BGRA2BGR);
-    } else if (rectifiedImage.channels() != 3) {
+    } else if (rectifiedImage.channels() != 1 && rectifiedImage.channels() != 3) {
         return rectifiedImage; // 不支持的通道数，直接返回原图
     }
 
-    std::vector<int> bCount(256, 0), gCount(256, 0), rCount(256, 0);
+    // 每个通道统计直方图，灰度图只有一个通道
+    const int channels = rectifiedImage.channels();
+    std::vector<std::vector<int>> counts(channels, std::vector<int>(256, 0));
     for (int y = 0; y < rectifiedImage.rows; y++) {
-        const auto row = rectifiedImage.ptr<cv::Vec3b>(y);
-        for (int x = 0; x < rectifiedImage.cols; x++) {
-            bCount[row[x][0]]++;
-            gCount[row[x][1]]++;
-            rCount[row[x][2]]++;
+        const auto row = rectifiedImage.ptr<uchar>(y);
+        for (int x = 0; x < rectifiedImage.cols * channels; x++) {
+            counts[x % channels][row[x]]++;
         }
     }
 
@@ -190,33 +290,22 @@ cv::Mat RectifyPolygonToRect(const cv::Mat &img, const ZXing::Barcode &bc, bool
         }
         return {lo, hi};
     };
-    const auto [bLow, bHigh] = calc_lo_hi(bCount);
-    const auto [gLow, gHigh] = calc_lo_hi(gCount);
-    const auto [rLow, rHigh] = calc_lo_hi(rCount);
 
-    cv::Mat fimg;
-    rectifiedImage.convertTo(fimg, CV_32F);
-    {
-        std::vector<cv::Mat> channels(3);
-        cv::split(fimg, channels);
-        const auto norm_clip = [](cv::Mat &ch, int lo, int hi) {
-            ch = (ch - lo) / (hi - lo);
-            cv::min(ch, 1.0, ch);
-            cv::max(ch, 0.0, ch);
-        };
-        norm_clip(channels[0], bLow, bHigh);
-        norm_clip(channels[1], gLow, gHigh);
-        norm_clip(channels[2], rLow, rHigh);
-        cv::merge(channels, fimg);
+    // 对比度拉伸与 3x^2 - 2x^3 亮度映射都只取决于像素值，预先算成每个通道 256 项的查找表
+    cv::Mat lut(1, 256, CV_8UC(channels));
+    for (int c = 0; c < channels; c++) {
+        const auto [lo, hi] = calc_lo_hi(counts[c]);
+        for (int v = 0; v < 256; v++) {
+            double x = v >= hi ? 1.0 : 0.0;
+            if (hi > lo) {
+                x = std::clamp(static_cast<double>(v - lo) / (hi - lo), 0.0, 1.0);
+            }
+            lut.ptr<uchar>()[v * channels + c] = cv::saturate_cast<uchar>(255.0 * (3 * x * x - 2 * x * x * x));
+        }
     }
 
-    cv::Mat mat1;
-    cv::pow(fimg, 2, mat1);
-    cv::Mat mat2;
-    cv::pow(fimg, 3, mat2);
     cv::Mat enhanced;
-    cv::Mat(3 * mat1 - 2 * mat2).convertTo(enhanced, CV_8U, 255.0);
-
+    cv::LUT(rectifiedImage, lut, enhanced);
     return enhanced;
 }
 
@@ -227,6 +316,10 @@ CameraWidget::CameraWidget(QWidget *parent)
     setMinimumSize(800, 600);
     this->installEventFilter(this);
 
+    const auto batchConfig = BatchConfig::loadFromConfig("./setting/config.json");
+    pngOptions = {batchConfig.pngCompressionLevel, batchConfig.pngFilter};
+    scanConfig = ScanConfig::loadFromConfig("./setting/config.json");
+
     mainLayout = new QVBoxLayout(this);
     menuBar = new QMenuBar(this);
 
@@ -297,6 +390,8 @@ CameraWidget::CameraWidget(QWidget *parent)
 
         currentBarcodeFormat = mask;
         isEnabledScan = anyChecked;
+        // 换了条码类型后，静止的画面也要按新类型重新解码
+        frameGate.invalidate();
     };
 
     for (const auto *act : formatActions) {
@@ -485,6 +580,11 @@ CameraWidget::CameraWidget(QWidget *parent)
 }
 
 void CameraWidget::updateLastFromModel() {
+    std::lock_guard lock(lastMutex);
+    // 删除记录后仍在画面中的条码可以重新记录
+    recentCodes.clear();
+    visibleCodes.clear();
+    visibleSequence = 0;
     if (resultModel->rowCount() == 0) {
         // 表格空了，重置
         lastContent.clear();
@@ -587,17 +687,21 @@ void CameraWidget::startCamera(int camIndex) {
         cap->set(cv::CAP_PROP_FRAME_WIDTH, config.width);
         cap->set(cv::CAP_PROP_FRAME_HEIGHT, config.height);
         cap->set(cv::CAP_PROP_FPS, config.fps);
+        const auto layout = camera::FrameConverter::request(*cap, config.pixelFormat);
+        // 驱动实际协商的帧率，不支持查询时为 0，由节奏控制按实测帧间隔估计
+        const double negotiatedFps = cap->get(cv::CAP_PROP_FPS);
 
-        spdlog::info("Selected Camera Config - Resolution: {}x{}, FPS: {}, Pixel Format: {}",
+        spdlog::info("Selected Camera Config - Resolution: {}x{}, FPS: {} (negotiated {}), Pixel Format: {}",
                      config.width,
                      config.height,
                      config.fps,
+                     negotiatedFps,
                      config.pixelFormat.toStdString());
 
         // 主线程进行操作
         QMetaObject::invokeMethod(
             this,
-            [this, cap = std::move(cap), configs, config, camIndex]() mutable {
+            [this, cap = std::move(cap), configs, config, camIndex, negotiatedFps, layout]() mutable {
                 if (cameraState != CameraState::Starting) {
                     return;
                 }
@@ -608,7 +712,18 @@ void CameraWidget::startCamera(int camIndex) {
                 lastSuccessfulCameraIndex = camIndex;
                 cameraState = CameraState::Running;
                 cameraStatusLabel->setText(tr("摄像头已启动"));
+                shownSequence = 0;
+                pacer.reset(negotiatedFps, scanConfig.decodeFps);
+                pixelLayout = layout;
+                roiTracker.reset(scanConfig.fullScanInterval, scanConfig.roiMargin);
+                frameGate.reset(scanConfig.blurThreshold, scanConfig.motionThreshold);
+                beepLatency.reset();
+                // 上次停止时在途帧认领的条码未写入表格，按表格重新确定上一次的结果，这些条码可以再次记录
+                updateLastFromModel();
                 captureThread = std::thread(&CameraWidget::captureLoop, this);
+                for (int i = 0; i < DecodeThreadCount(); ++i) {
+                    decodeThreads.emplace_back(&CameraWidget::decodeLoop, this);
+                }
             },
             Qt::QueuedConnection);
     });
@@ -627,6 +742,14 @@ void CameraWidget::stopCamera() {
     if (captureThread.joinable()) {
         captureThread.join();
     }
+    decodeSlot.wake();
+    for (auto &thread : decodeThreads) {
+        thread.join();
+    }
+    decodeThreads.clear();
+    // 释放残留的帧，下次启动不会显示旧画面
+    decodeSlot.take();
+    displaySlot.take();
 
     if (capture) {
         if (capture->isOpened()) {
@@ -637,81 +760,118 @@ void CameraWidget::stopCamera() {
     capture = nullptr;
     cameraState = CameraState::Stopped;
     cameraStatusLabel->setText(tr("摄像头已停止"));
+
+    if (const auto latency = beepLatency.summary(); latency.count > 0) {
+        spdlog::info("Capture-to-beep latency over {} codes: p50 {:.1f} ms, p99 {:.1f} ms (parallel families: {})",
+                     latency.count,
+                     latency.p50Ms,
+                     latency.p99Ms,
+                     scanConfig.parallelFamilies);
+    }
 }
 
-void CameraWidget::updateFrame(const FrameResult &r) const {
-    // 显示视频帧
-    frameWidget->setFrame(r.frame);
+void CameraWidget::showLatestFrame() {
+    // 先清除标记再取帧，之后到达的帧会重新排队一次调用
+    displayPending = false;
+    if (const auto frame = displaySlot.take(); frame && running) {
+        // 只为预览转换 BGR，并且先缩小到控件的物理像素尺寸
+        const QSize bound = frameWidget->size() * frameWidget->devicePixelRatioF();
+        const cv::Size source = camera::FrameConverter::imageSize(frame->image, frame->layout);
+        const cv::Mat bgr = camera::FrameConverter::toBgr(frame->image, frame->layout, {bound.width(), bound.height()});
+        frameWidget->setFrame(bgr, QSize(source.width, source.height));
+        const auto stats = pacer.stats();
+        const auto gated = frameGate.stats();
+        const QString status = tr("摄像头运行中... 采集 %1 fps，解码 %2 fps (%3 ms)，丢弃 %4 帧，模糊 %5，静止 %6");
+        cameraStatusLabel->setText(status.arg(stats.captureFps, 0, 'f', 1)
+                                       .arg(stats.decodeFps, 0, 'f', 1)
+                                       .arg(stats.decodeMs, 0, 'f', 1)
+                                       .arg(stats.skipped + decodeSlot.dropped())
+                                       .arg(gated.blurry)
+                                       .arg(gated.unchanged));
+    }
+}
 
-    cameraStatusLabel->setText(tr("摄像头运行中..."));
+void CameraWidget::updateFrame(const FrameResult &r) {
+    // 多个解码线程的结果可能乱序到达，叠加框只按更新的结果刷新；
+    // 新条码只由一个解码线程认领，即使晚到也要记录
+    const bool newer = r.sequence > shownSequence;
+    const bool anyNew = std::ranges::any_of(r.detections, &BarcodeDetection::isNew);
+    if (!running || (!newer && !anyNew)) {
+        return;
+    }
+    if (newer) {
+        shownSequence = r.sequence;
+        frameWidget->setOverlays(r.overlays);
+    }
 
-    if (r.hasBarcode) {
-        barcodeStatusLabel->setText(tr("检测到 ") + r.type + tr(" 码"));
-        barcodeStatusLabel->setProperty("detected", true);
-        barcodeStatusLabel->style()->unpolish(barcodeStatusLabel);
-        barcodeStatusLabel->style()->polish(barcodeStatusLabel);
+    if (r.detections.empty()) {
+        return;
+    }
+    if (r.detections.size() == 1) {
+        barcodeStatusLabel->setText(tr("检测到 ") + r.detections.front().type + tr(" 码"));
+    } else {
+        barcodeStatusLabel->setText(tr("检测到 %1 个条码").arg(r.detections.size()));
+    }
+    barcodeStatusLabel->setProperty("detected", true);
+    barcodeStatusLabel->style()->unpolish(barcodeStatusLabel);
+    barcodeStatusLabel->style()->polish(barcodeStatusLabel);
+    barcodeClearTimer->start(3000);
 
-        QString resultText = QString(tr("条码类型: %1\n内容: %2\n时间: %3\n------------------------\n"))
-                                 .arg(r.type)
-                                 .arg(r.content)
-                                 .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+    // 最近已记录的条码在解码线程中已经筛掉，不会生成修正图
+    if (!anyNew) {
+        return;
+    }
 
-        // 检查是否与上一条记录相同
-        if (r.content == lastContent && r.type == lastType) {
-            barcodeClearTimer->start(3000);
-            return;
-        }
+    // 新条码识别成功时播放 beep
+    playBeep();
+    beepLatency.record(std::chrono::steady_clock::now() - r.capturedAt);
 
-        // 新条码识别成功时播放 beep
-        playBeep();
+    if (isDebugMode) {
+        saveDebugFrame(r);
+    }
 
-        if (isDebugMode) {
-            saveDebugFrame(r);
+    for (const auto &detection : r.detections) {
+        if (detection.isNew && !detection.rectifiedImage.empty()) {
+            addResultRow(detection);
         }
+    }
+}
 
-        // 更新上一次的记录
-        lastContent = r.content;
-        lastType = r.type;
-
-        QList<QStandardItem *> rowItems;
-        rowItems << new QStandardItem(QDateTime::currentDateTime().toString("hh:mm:ss"));
-        QStandardItem *imageItem = new QStandardItem();
-        if (r.rectifiedImage.empty()) {
-            // If the rectified image is empty, skip adding this result
-            return;
-        }
-        QImage img = QImage(static_cast<uchar *>(r.rectifiedImage.data),
-                            r.rectifiedImage.cols,
-                            r.rectifiedImage.rows,
-                            static_cast<int>(r.rectifiedImage.step),
-                            QImage::Format_RGB888)
-                         .rgbSwapped();
-        QPixmap pixmap = QPixmap::fromImage(img).scaled(128, 128, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        imageItem->setData(pixmap, Qt::DecorationRole);
-        rowItems << imageItem;
-        rowItems << new QStandardItem(r.type);
-        rowItems << new QStandardItem(r.content);
-        // 存储 PNG 数据以便导出
-        QByteArray pngData;
-        QBuffer buffer(&pngData);
-        buffer.open(QIODevice::WriteOnly);
-        img.save(&buffer, "PNG");
-        buffer.close();
-        rowItems << new QStandardItem(QString::fromLatin1(pngData.toBase64()));
-        rowItems << new QStandardItem(QString::number(img.width()));  // 图片宽度
-        rowItems << new QStandardItem(QString::number(img.height())); // 图片高度
-
-        // 设置颜色
-        rowItems[2]->setForeground(Qt::blue);  // 类型蓝色
-        resultModel->insertRow(0, rowItems);   // 插入到顶部
-        resultDisplay->setRowHeight(0, 128);   // 设置行高
-        resultDisplay->setColumnWidth(1, 128); // 设置图片列宽度
-
-        // 限制行数
-        if (resultModel->rowCount() > 50) {
-            resultModel->removeRow(50);
-        }
-        barcodeClearTimer->start(3000);
+void CameraWidget::addResultRow(const BarcodeDetection &detection) {
+    QList<QStandardItem *> rowItems;
+    rowItems << new QStandardItem(QDateTime::currentDateTime().toString("hh:mm:ss"));
+    QStandardItem *imageItem = new QStandardItem();
+    // 未增强时亮度平面上修正出的是灰度图
+    const cv::Mat &rectified = detection.rectifiedImage;
+    const bool gray = rectified.channels() == 1;
+    QImage img = QImage(static_cast<uchar *>(rectified.data),
+                        rectified.cols,
+                        rectified.rows,
+                        static_cast<int>(rectified.step),
+                        gray ? QImage::Format_Grayscale8 : QImage::Format_RGB888);
+    if (!gray) {
+        img = img.rgbSwapped();
+    }
+    QPixmap pixmap = QPixmap::fromImage(img).scaled(128, 128, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    imageItem->setData(pixmap, Qt::DecorationRole);
+    rowItems << imageItem;
+    rowItems << new QStandardItem(detection.type);
+    rowItems << new QStandardItem(detection.content);
+    // 存储 PNG 数据以便导出
+    const QByteArray pngData = io::PngEncoder::encode(img, pngOptions);
+    rowItems << new QStandardItem(QString::fromLatin1(pngData.toBase64()));
+    rowItems << new QStandardItem(QString::number(img.width()));  // 图片宽度
+    rowItems << new QStandardItem(QString::number(img.height())); // 图片高度
+
+    // 设置颜色
+    rowItems[2]->setForeground(Qt::blue);  // 类型蓝色
+    resultModel->insertRow(0, rowItems);   // 插入到顶部
+    resultDisplay->setRowHeight(0, 128);   // 设置行高
+    resultDisplay->setColumnWidth(1, 128); // 设置图片列宽度
+
+    // 限制行数
+    if (resultModel->rowCount() > 50) {
+        resultModel->removeRow(50);
     }
 }
 
@@ -836,58 +996,286 @@ bool CameraWidget::exportResultsToXlsx(const QString &filePath) {
 
 void CameraWidget::captureLoop() {
     spdlog::info("Capture thread started");
+    std::uint64_t sequence = 0;
     while (running) {
-        FrameResult result;
+        // 每次读入新的 Mat，上一帧可能仍在显示或解码中
         cv::Mat frame;
         *capture >> frame;
+        const auto capturedAt = std::chrono::steady_clock::now();
 
         if (frame.empty()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            std::this_thread::sleep_for(pacer.emptyFrameDelay());
+            continue;
+        }
+
+        const auto requested = pixelLayout.load();
+        const auto layout = camera::FrameConverter::classify(frame, requested);
+        if (!layout) {
+            // 后端接受了原始输出的请求，返回的数据却无法识别，改回由后端转换为 BGR
+            spdlog::warn("Unrecognised {}x{} frame (type {}) for raw {} output, falling back to BGR",
+                         frame.cols,
+                         frame.rows,
+                         frame.type(),
+                         magic_enum::enum_name(requested));
+            capture->set(cv::CAP_PROP_CONVERT_RGB, 1);
+            pixelLayout = camera::PixelLayout::BGR;
             continue;
         }
 
-        processFrame(frame, result);
-        result.frame = frame;
+        // 读帧按摄像头帧率阻塞，不额外休眠；超过目标解码帧率的帧只用于预览
+        // 显示与解码共享同一份只读的原始帧，各自按需转换
+        ++sequence;
+        const bool decode = pacer.frameCaptured();
+        displaySlot.publish(std::make_unique<CapturedFrame>(CapturedFrame{frame, sequence, *layout, capturedAt}));
+        if (!displayPending.exchange(true)) {
+            QMetaObject::invokeMethod(this, [this] { showLatestFrame(); }, Qt::QueuedConnection);
+        }
+        if (decode) {
+            decodeSlot.publish(
+                std::make_unique<CapturedFrame>(CapturedFrame{std::move(frame), sequence, *layout, capturedAt}));
+        }
+    }
+    const auto stats = pacer.stats();
+    const auto gated = frameGate.stats();
+    spdlog::info("Capture thread stopped: {} frames captured, {} decoded, {} skipped by pacing, {} dropped while busy, "
+                 "{} blurry, {} unchanged",
+                 stats.captured,
+                 stats.decoded,
+                 stats.skipped,
+                 decodeSlot.dropped(),
+                 gated.blurry,
+                 gated.unchanged);
+}
+
+void CameraWidget::decodeLoop() {
+    while (const auto captured = decodeSlot.waitTake(running)) {
+        // 在缩略图上先筛一遍，模糊或与上次解码相同的画面不做完整的条码搜索，保留上一次的识别结果
+        cv::Mat thumbnail;
+        if (isEnabledScan) {
+            thumbnail = camera::FrameConverter::thumbnail(
+                captured->image, captured->layout, camera::FrameGate::kThumbnailWidth);
+            const auto verdict = frameGate.check(thumbnail, captured->sequence);
+            if (verdict == camera::GateVerdict::Unchanged) {
+                // 画面未变化，参考帧中的条码仍在画面中，不能因为没有解码而过期
+                touchRecentCodes();
+            }
+            if (verdict != camera::GateVerdict::Decode) {
+                continue;
+            }
+        }
+
+        const auto started = camera::FramePacer::Clock::now();
+        FrameResult result;
+        result.sequence = captured->sequence;
+        result.frame = captured->image;
+        result.layout = captured->layout;
+        result.capturedAt = captured->capturedAt;
+        // 有了结论（解出了全部条码或画面中没有条码）才作为参考帧，检测到却未能解出时相似的下一帧仍要解码
+        if (processFrame(captured->image, captured->layout, result) && !thumbnail.empty()) {
+            frameGate.settle(thumbnail, captured->sequence);
+        }
+        pacer.frameDecoded(camera::FramePacer::Clock::now() - started);
 
-        QMetaObject::invokeMethod(this, [this, result] { updateFrame(result); }, Qt::QueuedConnection);
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        QMetaObject::invokeMethod(
+            this, [this, result = std::move(result)] { updateFrame(result); }, Qt::QueuedConnection);
     }
-    spdlog::info("Capture thread stopped");
 }
 
-void CameraWidget::processFrame(cv::Mat &frame, FrameResult &out) const {
+bool CameraWidget::processFrame(const cv::Mat &frame, camera::PixelLayout layout, FrameResult &out) {
     if (!isEnabledScan) {
-        return;
+        return true;
     }
-    const auto barcodes = ZXing::ReadBarcodes(ImageViewFromMat(frame));
-    for (auto &bc : barcodes) {
-        if (!bc.isValid()) {
-            continue;
+    const auto view = ImageViewFromFrame(frame, layout);
+    const cv::Rect whole(cv::Point(0, 0), camera::FrameConverter::imageSize(frame, layout));
+    // 只搜索选中的格式，不再识别全部格式后再过滤；同时返回检测到却未能解出的条码，用于判断本帧是否有了结论
+    auto options = readerOptions();
+    options.setReturnErrors(true);
+    std::vector<std::pair<ZXing::Barcode, std::array<cv::Point, 4>>> found;
+    std::vector<cv::Rect> unresolved;
+    const auto scan = [&](const cv::Rect &region) {
+        const auto cropped = view.cropped(region.x, region.y, region.width, region.height);
+        for (auto &bc : ReadBarcodesByFamily(cropped, options, scanConfig.parallelFamilies)) {
+            auto corners = CornersOf(bc, region.tl());
+            const auto box = cv::boundingRect(std::vector<cv::Point>(corners.begin(), corners.end()));
+            if (!bc.isValid()) {
+                unresolved.push_back(box);
+                continue;
+            }
+            // 区域之间或与缩小图上已解出的条码重叠时，同一个条码会被解出两次
+            const bool duplicate = std::ranges::any_of(found, [&](const auto &entry) {
+                const auto &[other, otherCorners] = entry;
+                const auto otherBox =
+                    cv::boundingRect(std::vector<cv::Point>(otherCorners.begin(), otherCorners.end()));
+                return other.format() == bc.format() && other.bytes() == bc.bytes() && !(otherBox & box).empty();
+            });
+            if (!duplicate) {
+                found.emplace_back(std::move(bc), corners);
+            }
         }
+    };
 
-        // 如果 currentBarcodeFormat = None -> 全部模式
-        if (currentBarcodeFormat != ZXing::BarcodeFormat::None &&
-            !(static_cast<int>(bc.format()) & static_cast<int>(currentBarcodeFormat))) {
-            continue; // 当前格式未被选中，跳过
+    // 修正与缩小用的图像：亮度平面，BGR 帧保留彩色；用到时才抽取
+    cv::Mat plane;
+    const auto sourcePlane = [&]() -> const cv::Mat & {
+        if (plane.empty()) {
+            plane = layout == camera::PixelLayout::BGR ? frame : camera::FrameConverter::luma(frame, layout);
         }
+        return plane;
+    };
 
-        out.hasBarcode = true;
-        out.type = QString::fromStdString(ZXing::ToString(bc.format()));
-        out.content = QString::fromStdString(bc.text());
-        out.rectifiedImage = RectifyPolygonToRect(frame, bc, isEnhanceEnabled);
-        DrawBarcode(frame, bc);
+    // 全帧扫描：大图先在缩小的图像上解码，能直接解出的条码只换算坐标，
+    // 检测到却未能解出的候选只在其所在区域按原分辨率重新解码；缩小后什么都没发现才扫描整个原图
+    const auto scanWhole = [&] {
+        const int scale = scanConfig.pyramidScale;
+        if (scale < 2 || std::min(whole.width, whole.height) < scanConfig.pyramidMinSide) {
+            scan(whole);
+            return;
+        }
+        cv::Mat small;
+        cv::resize(sourcePlane(), small, {}, 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+        std::vector<cv::Rect> candidates;
+        for (auto &bc : ReadBarcodesByFamily(ImageViewFromMat(small), options, scanConfig.parallelFamilies)) {
+            auto corners = CornersOf(bc, {0, 0}, scale);
+            if (bc.isValid()) {
+                found.emplace_back(std::move(bc), corners);
+                continue;
+            }
+            const auto box = cv::boundingRect(std::vector<cv::Point>(corners.begin(), corners.end()));
+            candidates.push_back(camera::RoiTracker::enlarge(box, scanConfig.roiMargin, whole.size()));
+        }
+        if (found.empty() && candidates.empty()) {
+            scan(whole);
+            return;
+        }
+        camera::RoiTracker::mergeOverlapping(candidates);
+        for (const auto &region : candidates) {
+            scan(region);
+        }
+    };
+
+    // 先在上一帧条码周围解码，区域内没有找到（跟丢）时再扫描整帧；
+    // 定期全帧扫描按原分辨率进行，缩小后看不清的小条码在已有条码被跟踪期间也能被发现
+    const auto plan = roiTracker.plan(whole.size());
+    for (const auto &region : plan.regions) {
+        scan(region);
+    }
+    if (plan.periodic) {
+        scan(whole);
+    } else if (found.empty()) {
+        scanWhole();
+    }
+    std::vector<cv::Rect> boxes;
+    for (const auto &[bc, corners] : found) {
+        boxes.push_back(cv::boundingRect(std::vector<cv::Point>(corners.begin(), corners.end())));
+    }
+    roiTracker.update(out.sequence, boxes);
+    // 跟踪区域截断或另一次扫描已解出的不算未解出
+    std::erase_if(unresolved, [&](const cv::Rect &candidate) {
+        return std::ranges::any_of(boxes, [&](const cv::Rect &box) { return !(candidate & box).empty(); });
+    });
+    const bool settled = unresolved.empty();
+
+    for (const auto &[bc, corners] : found) {
+        BarcodeDetection detection;
+        detection.type = QString::fromStdString(ZXing::ToString(bc.format()));
+        detection.content = QString::fromStdString(bc.text());
+        detection.corners = corners;
+        out.overlays.push_back({corners, detection.content});
+        out.detections.push_back(std::move(detection));
+    }
+    // 先去重再修正：同一个条码停留在画面中时，透视变换与增强只在第一次识别到时做一次；
+    // 没有识别到条码的帧也要认领，清空画面中的条码
+    claimNewCodes(out.sequence, out.detections);
+    if (out.detections.empty()) {
+        return settled;
+    }
+    std::vector<BarcodeDetection *> fresh;
+    for (auto &detection : out.detections) {
+        if (detection.isNew) {
+            fresh.push_back(&detection);
+        }
+    }
+    if (!fresh.empty()) {
+        const cv::Mat &source = sourcePlane();
+        // 一帧中有多个新条码（托盘、多码标签）时并行修正
+        cv::parallel_for_(cv::Range(0, static_cast<int>(fresh.size())), [&](const cv::Range &range) {
+            for (int i = range.start; i < range.end; ++i) {
+                fresh[i]->rectifiedImage = RectifyPolygonToRect(source, fresh[i]->corners, isEnhanceEnabled);
+            }
+        });
     }
+    return settled;
+}
+
+void CameraWidget::claimNewCodes(std::uint64_t sequence, std::vector<BarcodeDetection> &detections) {
+    std::lock_guard lock(lastMutex);
+    const auto now = std::chrono::steady_clock::now();
+    std::erase_if(recentCodes, [now](const auto &entry) { return now - entry.second > DUPLICATE_WINDOW; });
+    // 乱序完成的旧帧不覆盖画面中的条码
+    const bool latest = sequence >= visibleSequence;
+    if (latest) {
+        visibleSequence = sequence;
+        visibleCodes.clear();
+    }
+    for (auto &detection : detections) {
+        auto key = std::make_pair(detection.type, detection.content);
+        if (latest) {
+            visibleCodes.push_back(key);
+        }
+        const bool recent = recentCodes.contains(key);
+        recentCodes[std::move(key)] = now;
+        // 最近出现过的条码（包括同一帧中重复的）以及最后记录的条码都不再记录
+        detection.isNew = !recent && !(detection.content == lastContent && detection.type == lastType);
+        if (detection.isNew) {
+            lastContent = detection.content;
+            lastType = detection.type;
+        }
+    }
+}
+
+void CameraWidget::touchRecentCodes() {
+    std::lock_guard lock(lastMutex);
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto &key : visibleCodes) {
+        recentCodes[key] = now;
+    }
+}
+
+ZXing::ReaderOptions CameraWidget::readerOptions() const {
+    // currentBarcodeFormat = None 时不限制格式
+    return ZXing::ReaderOptions()
+        .setFormats(currentBarcodeFormat.load())
+        .setTryHarder(scanConfig.tryHarder)
+        .setTryRotate(scanConfig.tryRotate)
+        .setTryInvert(scanConfig.tryInvert)
+        .setTryDownscale(scanConfig.tryDownscale)
+        .setDownscaleThreshold(scanConfig.downscaleThreshold)
+        .setDownscaleFactor(scanConfig.downscaleFactor);
 }
 
 void CameraWidget::saveDebugFrame(const FrameResult &r) const {
     if (!std::filesystem::exists("debug_frames")) {
         std::filesystem::create_directory("debug_frames");
     }
-    const std::string filename = std::format(
-        "./debug_frames/scan_{}_{}.png", r.type.toStdString(), sysinfo::getCurrentTimeString("%Y-%m-%d_%H-%M-%S"));
-    spdlog::info(
-        "识别到条码: Type = {}, Content = {} 保存到: {}", r.type.toStdString(), r.content.toStdString(), filename);
-    cv::imwrite(filename, r.frame);
+    const auto &primary = r.detections.front();
+    const std::string filename = std::format("./debug_frames/scan_{}_{}.png",
+                                             primary.type.toStdString(),
+                                             sysinfo::getCurrentTimeString("%Y-%m-%d_%H-%M-%S"));
+    for (const auto &detection : r.detections) {
+        spdlog::info("识别到条码: Type = {}, Content = {} 保存到: {}",
+                     detection.type.toStdString(),
+                     detection.content.toStdString(),
+                     filename);
+    }
+    // 预览上的条码框由界面绘制，保存时画到副本上
+    cv::Mat annotated = camera::FrameConverter::toBgr(r.frame, r.layout);
+    if (annotated.data == r.frame.data) {
+        annotated = annotated.clone();
+    }
+    for (const auto &overlay : r.overlays) {
+        DrawBarcode(annotated, overlay);
+    }
+    cv::imwrite(filename, annotated);
 }
 
 void CameraWidget::retranslate() {
@@ -946,6 +1334,8 @@ void CameraWidget::onCameraConfigSelected(CameraConfig config) {
     double actual_height = capture->get(cv::CAP_PROP_FRAME_HEIGHT);
     double actual_fps = capture->get(cv::CAP_PROP_FPS);
     spdlog::info("Actual Camera Config - Resolution: {}x{}, FPS: {}", actual_width, actual_height, actual_fps);
+    pacer.setCameraFps(actual_fps);
+    pixelLayout = camera::FrameConverter::request(*capture, config.pixelFormat);
 }
 
 void CameraWidget::loadCameraConfigs(const std::vector<CameraConfig> &configs) {
@@ -3,18 +3,31 @@
 
 #include "CameraConfig.h"
 #include "FrameWidget.h"
+#include "camera/FrameGate.h"
+#include "camera/FramePacer.h"
+#include "camera/LatencyRecorder.h"
+#include "camera/LatestSlot.h"
+#include "camera/RoiTracker.h"
 #include "commondef.h"
+#include "components/ScanConfig.h"
+#include "io/PngEncoder.h"
 #include <QStatusBar>
 #include <QTextEdit>
 #include <QVBoxLayout>
 #include <QWidget>
 #include <ZXing/BarcodeFormat.h>
+#include <ZXing/ReaderOptions.h>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <future>
+#include <map>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 #include <qactiongroup.h>
 #include <qcombobox.h>
 #include <thread>
+#include <vector>
 
 class QHideEvent;
 class QPushButton;
@@ -95,12 +108,24 @@ private:
     void onCameraIndexChanged(int index);
 
     /**
-     * @brief 更新视频帧显示
+     * @brief 显示采集线程交来的最新一帧
+     *
+     * 在UI线程中调用，同一时间最多只有一次排队中的调用，UI 繁忙时中间的帧直接丢弃
+     */
+    void showLatestFrame();
+
+    /**
+     * @brief 处理条码识别结果
      * 
-     * 在UI线程中更新视频帧显示，并处理条码识别结果
+     * 在UI线程中更新预览上的条码框并记录本帧所有新识别的条码，比已处理结果更旧且没有新条码的直接忽略
      * @param r 视频帧处理结果
      */
-    void updateFrame(const FrameResult &r) const;
+    void updateFrame(const FrameResult &r);
+
+    /**
+     * @brief 在结果表格顶部加入一条新识别的条码
+     */
+    void addResultRow(const BarcodeDetection &detection);
 
     /**
      * @brief 导出扫描结果为 HTML 文件
@@ -114,18 +139,55 @@ private:
     /**
      * @brief 摄像头捕获循环函数
      * 
-     * 在独立线程中持续捕获摄像头视频帧并进行处理
+     * 在独立线程中持续捕获摄像头视频帧，交给显示和解码两个交接槽后立即读取下一帧，
+     * 不等待解码完成，预览帧率不受解码耗时影响
      */
     void captureLoop();
 
+    /**
+     * @brief 解码线程循环函数
+     *
+     * 多个解码线程各自从交接槽取走最新一帧，相邻的帧由不同线程并行解码，处理不过来的旧帧被丢弃
+     */
+    void decodeLoop();
+
     /**
      * @brief 处理视频帧中的条码识别
      * 
-     * 对输入的视频帧进行条码识别，并在找到条码时进行标记
-     * @param frame 输入的视频帧（会被修改以绘制条码标记）
+     * 对输入的视频帧进行条码识别，记录每个条码的位置用于叠加显示。
+     * YUV 帧直接在亮度平面上解码与修正，不转换为 BGR；跟踪到条码时先只解码其周围的区域，
+     * 大图的全帧扫描先在缩小的图像上进行
+     * @param frame 输入的原始视频帧
+     * @param layout 原始帧的像素排列
      * @param out 识别结果输出参数
+     * @return 本帧有了结论：没有检测到却未能解出的条码，可作为筛选的参考帧
+     */
+    bool processFrame(const cv::Mat &frame, camera::PixelLayout layout, FrameResult &out);
+
+    /**
+     * @brief 按当前选择的条码格式和扫码配置生成解码参数
+     *
+     * 格式集合直接交给解码器，未选中的格式不会被搜索。
+     */
+    ZXing::ReaderOptions readerOptions() const;
+
+    /**
+     * @brief 逐个判断条码是否需要记录，结果写入 isNew
+     *
+     * 最近几秒内出现过的条码与最后记录的条码不再记录，每次出现都会延长其有效期；
+     * 多个解码线程同时识别到同一个新条码时只有一个判为新条码。
+     * 序号最新的帧的条码记为画面中的条码，供 touchRecentCodes() 使用。
+     * @param sequence 帧序号
+     * @param detections 本帧识别到的条码，可为空
+     */
+    static void claimNewCodes(std::uint64_t sequence, std::vector<BarcodeDetection> &detections);
+
+    /**
+     * @brief 延长画面中的条码的有效期
+     *
+     * 筛选判为未变化的帧不解码，条码仍停留在画面中，有效期不能因此过期。
      */
-    void processFrame(cv::Mat &frame, FrameResult &out) const;
+    static void touchRecentCodes();
 
     /**
      * @brief 摄像头配置切换处理函数
@@ -162,7 +224,7 @@ private:
     /**
      * @brief 根据表格第一行内容更新静态成员变量 lastContent 和 lastType
      * 
-     * 在删除结果时进行调用
+     * 在删除结果和启动摄像头时进行调用
      */
     void updateLastFromModel();
     /** 
@@ -182,12 +244,26 @@ private:
         Stopping
     };
 
-    cv::VideoCapture *capture = nullptr; /**< 摄像头捕获对象，用于获取视频帧 */
-    std::atomic_bool running{false};     /**< 控制摄像头捕获循环是否运行的原子布尔值 */
-    std::thread captureThread;           /**< 摄像头捕获线程对象 */
-    std::future<void> asyncOpenFuture;   /**< 异步打开摄像头的 future 对象 */
+    /** 最近出现过的条码（类型、内容）与最后出现的时间 */
+    using RecentCodes = std::map<std::pair<QString, QString>, std::chrono::steady_clock::time_point>;
+
+    cv::VideoCapture *capture = nullptr;           /**< 摄像头捕获对象，用于获取视频帧 */
+    std::atomic_bool running{false};               /**< 控制摄像头捕获循环是否运行的原子布尔值 */
+    std::thread captureThread;                     /**< 摄像头捕获线程对象 */
+    std::vector<std::thread> decodeThreads;        /**< 解码线程 */
+    camera::LatestSlot<CapturedFrame> decodeSlot;  /**< 采集到解码的交接槽，只保留最新一帧 */
+    camera::LatestSlot<CapturedFrame> displaySlot; /**< 采集到显示的交接槽，只保留最新一帧 */
+    std::atomic_bool displayPending{false};        /**< 是否已有排队中的 showLatestFrame 调用 */
+    std::uint64_t shownSequence = 0;               /**< 已处理的最新解码结果的帧序号，仅在UI线程访问 */
+    camera::FramePacer pacer;                      /**< 采集与解码的节奏控制和统计 */
+    camera::RoiTracker roiTracker;                 /**< 条码位置跟踪，决定优先解码的区域 */
+    camera::FrameGate frameGate;                   /**< 解码前跳过模糊与未变化的帧 */
+    camera::LatencyRecorder beepLatency;           /**< 读到帧到提示音响起的延迟，仅在UI线程访问 */
+    ScanConfig scanConfig;                         /**< 摄像头扫码配置 */
+    std::future<void> asyncOpenFuture;             /**< 异步打开摄像头的 future 对象 */
     // bool cameraStarted = false;                /**< 标记摄像头是否已经启动 */
     std::atomic_bool isEnabledScan = true;                                  /**< 控制是否启用条码扫描功能的原子布尔值 */
+    std::atomic<camera::PixelLayout> pixelLayout{camera::PixelLayout::BGR}; /**< 向摄像头请求的原始帧像素排列 */
     QVBoxLayout *mainLayout = nullptr;                                      /**< 主布局管理器 */
     FrameWidget *frameWidget = nullptr;                                     /**< 视频帧显示组件 */
     QTableView *resultDisplay;                                              /**< 结果显示表格视图 */
@@ -209,7 +285,7 @@ private:
     QActionGroup *cameraActionGroup = nullptr;                              /**< 摄像头配置ActionGroup */
     int currentCameraIndex = 0;                                             /**< 当前选择的摄像头索引 */
     QComboBox *barcodeTypeCombo = nullptr;                                  /**< 条码类型选择组合框 */
-    ZXing::BarcodeFormat currentBarcodeFormat = ZXing::BarcodeFormat::None; /**< 当前选择的条码格式 */
+    std::atomic<ZXing::BarcodeFormat> currentBarcodeFormat = ZXing::BarcodeFormat::None; /**< 当前选择的条码格式 */
     QLabel *cameraStatusLabel;                                              /**< 摄像头状态标签 */
     QLabel *barcodeStatusLabel;                                             /**< 条码识别状态标签 */
     QTimer *barcodeClearTimer;                                              /**< 条码状态清除定时器 */
@@ -217,8 +293,13 @@ private:
     bool isDebugMode = false;                                               /**< 是否启用调试模式（保存识别帧） */
     static QString lastContent;                                             /**< 用于记录上一次扫码结果内容 */
     static QString lastType;                                                /**< 用于记录上一次扫码结果类型 */
+    static RecentCodes recentCodes;                                         /**< 最近出现过的条码与最后出现的时间 */
+    static std::vector<RecentCodes::key_type> visibleCodes;                 /**< 最近一次解码的帧中的条码 */
+    static std::uint64_t visibleSequence;                                   /**< visibleCodes 来自的帧序号 */
+    static std::mutex lastMutex;                                            /**< 保护上一次扫码结果，解码线程也会读写 */
     std::atomic<CameraState> cameraState{CameraState::Stopped};             /**< 记录当前摄像头状态 */
     int lastSuccessfulCameraIndex = -1; /**< 记录最后一次加载成功的摄像头id，用于切换摄像头失败时回退 */
+    io::PngOptions pngOptions;          /**< 识别结果图片的 PNG 编码参数，与批量保存一致 */
 };
 
 #endif // CAMERAWIDGET_H
\ No newline at end of file
@@ -3,7 +3,10 @@
 #include <QFile>
 #include <QImage>
 #include <QPainter>
+#include <QPen>
+#include <QPolygonF>
 #include <QStyleOption>
+#include <opencv2/imgproc.hpp>
 #include <spdlog/spdlog.h>
 namespace {
 
@@ -43,20 +46,19 @@ FrameWidget::FrameWidget(QWidget *parent)
     }
 }
 
-void FrameWidget::setFrame(const cv::Mat &bgr) {
+void FrameWidget::setFrame(const cv::Mat &bgr, QSize sourceSize) {
     if (bgr.empty() || bgr.type() != CV_8UC3) {
         spdlog::warn("PlayerWidget::setFrame received invalid mat");
         return;
     }
 
-    // 创建 RGB QImage 然后交换 R 和 B 通道
-    m_image = QImage(bgr.data,
-                     bgr.cols,
-                     bgr.rows,
-                     static_cast<int>(bgr.step),
-                     QImage::Format_RGB888)
-                  .rgbSwapped()
-                  .copy(); // 先交换通道再深拷贝
+    // 直接转换到 QImage 自己的缓冲区，只遍历一次像素
+    if (m_image.width() != bgr.cols || m_image.height() != bgr.rows || !m_image.isDetached()) {
+        m_image = QImage(bgr.cols, bgr.rows, QImage::Format_RGB888);
+    }
+    cv::Mat rgb(m_image.height(), m_image.width(), CV_8UC3, m_image.bits(), m_image.bytesPerLine());
+    cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
+    m_sourceSize = sourceSize.isEmpty() ? m_image.size() : sourceSize;
 
     update(); // 触发 Qt 重绘
 }
@@ -81,9 +83,35 @@ void FrameWidget::paintEvent(QPaintEvent *event) {
     const QRect dst = scaleKeepAspect(rect(), m_image.width(), m_image.height());
 
     painter.drawImage(dst, m_image);
+
+    if (m_overlays.empty()) {
+        return;
+    }
+    // 条码框与文字按图像到控件的缩放比例绘制
+    const double scaleX = static_cast<double>(dst.width()) / m_sourceSize.width();
+    const double scaleY = static_cast<double>(dst.height()) / m_sourceSize.height();
+    const auto toWidget = [&](const cv::Point &p) {
+        return QPointF(dst.x() + p.x * scaleX, dst.y() + p.y * scaleY);
+    };
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(QColor(0, 255, 0), 2));
+    for (const auto &overlay : m_overlays) {
+        QPolygonF polygon;
+        for (const auto &corner : overlay.corners) {
+            polygon << toWidget(corner);
+        }
+        painter.drawPolygon(polygon);
+        painter.drawText(toWidget(overlay.corners[3]) + QPointF(0, 20), overlay.text);
+    }
+}
+
+void FrameWidget::setOverlays(std::vector<BarcodeOverlay> overlays) {
+    m_overlays = std::move(overlays);
+    update();
 }
 
 void FrameWidget::clear() {
     m_image = QImage(); // 清空图像
+    m_overlays.clear(); // 清空叠加的条码框
     update();           // 触发重绘
 }
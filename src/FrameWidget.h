@@ -1,6 +1,8 @@
 #pragma once
+#include "commondef.h"
 #include <QWidget>
 #include <opencv2/core.hpp>
+#include <vector>
 
 /**
  * @class FrameWidget
@@ -14,9 +16,17 @@ public:
     /**
      * @brief 设置要显示的图像帧
      *  会自动触发重绘事件
-     * @param bgr 输入的 BGR 格式图像
+     * @param bgr 输入的 BGR 格式图像，可以是缩小到显示尺寸后的帧
+     * @param sourceSize 原始帧尺寸，叠加的条码坐标按它换算；为空时与图像尺寸相同
      */
-    void setFrame(const cv::Mat &bgr);
+    void setFrame(const cv::Mat &bgr, QSize sourceSize = {});
+
+    /**
+     * @brief 设置叠加显示的条码位置，坐标为原始帧坐标，绘制时随图像一起缩放
+     *
+     * 预览帧与解码结果分别到达，位置保留到下一次解码结果为止。
+     */
+    void setOverlays(std::vector<BarcodeOverlay> overlays);
 
     void clear();
 
@@ -29,5 +39,7 @@ protected:
     void paintEvent(QPaintEvent *event) override;
 
 private:
-    QImage m_image; // 转换后的图像
+    QImage m_image;                         // 转换后的图像
+    QSize m_sourceSize;                     // 原始帧尺寸
+    std::vector<BarcodeOverlay> m_overlays; // 叠加显示的条码位置
 };
\ No newline at end of file
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+#include <vector>
+
+namespace batch {
+
+/**
+ * @brief 批处理引擎参数
+ */
+struct EngineOptions {
+    int threadCount = 0;                             /**< 工作线程数，0 表示使用线程池的最大线程数 */
+    std::chrono::milliseconds targetChunkTime{20};   /**< 每个工作块的目标耗时，用于计算块大小 */
+    std::size_t maxChunkSize = 256;                  /**< 单个工作块的最大条目数 */
+    std::chrono::milliseconds progressInterval{100}; /**< 进度与剩余时间的上报间隔 */
+    QThreadPool *pool = nullptr;                     /**< 运行工作线程的线程池，为空时使用全局线程池 */
+};
+
+/**
+ * @class BatchEngine
+ * @brief 粗粒度分块 + 工作窃取的批处理引擎
+ *
+ * 与 QtConcurrent::mapped 逐条派发不同，每个工作线程按实测单条耗时一次领取一块条目，
+ * 本地队列空了之后先领取新投递的输入，再从其他线程的队列尾部窃取一半。
+ * 结果按块回报到 QFuture 中并保持输入顺序，进度和剩余时间按固定频率上报，
+ * 因此十万级的小文件不会把 GUI 事件循环淹没。
+ *
+ * 输入可以通过 feed() 分多次投递，close() 后所有条目处理完毕时 future 结束。
+ *
+ * 处理函数可以逐条处理（Out(const In &)），也可以一次处理整块（QVector<Out>(std::span<const In>)），
+ * 后者便于在块内合并 I/O，例如批量读取一块小文件。两种签名都可调用时优先按块处理。
+ *
+ * @tparam In 输入条目类型
+ * @tparam Out 结果类型，需可默认构造
+ */
+template <typename In, typename Out>
+class BatchEngine {
+    static_assert(std::is_default_constructible_v<Out>, "BatchEngine result type must be default constructible");
+
+public:
+    using Function = std::function<Out(const In &)>;
+    using ChunkFunction = std::function<QVector<Out>(std::span<const In>)>;
+
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, BatchEngine>)
+    explicit BatchEngine(F fn, EngineOptions options = {})
+        : state_(std::make_shared<State>(toChunkFunction(std::move(fn)), options)) {
+        state_->start(state_);
+    }
+
+    /**
+     * @brief 投递一批输入，可多次调用
+     */
+    void feed(std::vector<In> items) const {
+        state_->feed(std::move(items));
+    }
+
+    /**
+     * @brief 声明不再有新的输入
+     */
+    void close() const {
+        state_->close();
+    }
+
+    QFuture<Out> future() const {
+        return state_->iface.future();
+    }
+
+    /**
+     * @brief 阻塞直到已投递但未完成的条目不超过 limit，流式输入的生产者以此限制在途内存
+     * @return 任务被取消时返回 false
+     */
+    bool waitForBacklog(std::size_t limit) const {
+        return state_->waitForBacklog(limit);
+    }
+
+    /**
+     * @brief 一次性处理整批输入
+     */
+    template <typename F>
+    static QFuture<Out> run(std::vector<In> items, F fn, EngineOptions options = {}) {
+        BatchEngine engine(std::move(fn), options);
+        engine.feed(std::move(items));
+        engine.close();
+        return engine.future();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    template <typename F>
+    static ChunkFunction toChunkFunction(F fn) {
+        if constexpr (std::is_invocable_r_v<QVector<Out>, const F &, std::span<const In>>) {
+            return ChunkFunction(std::move(fn));
+        } else {
+            return [fn = std::move(fn)](std::span<const In> items) {
+                QVector<Out> results;
+                results.reserve(static_cast<int>(items.size()));
+                for (const auto &item : items) {
+                    try {
+                        results.push_back(fn(item));
+                    } catch (const std::exception &e) {
+                        spdlog::error("BatchEngine: item failed: {}", e.what());
+                        results.push_back(Out{});
+                    }
+                }
+                return results;
+            };
+        }
+    }
+
+    /**
+     * @brief 一段连续的输入区间，base 为 items[0] 在整个批次中的下标
+     */
+    struct Segment {
+        std::shared_ptr<const std::vector<In>> items;
+        std::size_t base = 0;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+
+        std::size_t size() const noexcept {
+            return end - begin;
+        }
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        Segment range;
+        double nsPerItem = 0; // 单条耗时的滑动平均，0 表示尚未测量
+    };
+
+    struct State {
+        State(ChunkFunction fn, EngineOptions options)
+            : fn(std::move(fn)), options(options) {}
+
+        void start(const std::shared_ptr<State> &self) {
+            QThreadPool *pool = options.pool ? options.pool : QThreadPool::globalInstance();
+            int threads = options.threadCount;
+            if (threads <= 0) {
+                threads = std::max(pool->maxThreadCount(), 1);
+            }
+
+            iface.reportStarted();
+            iface.setProgressRange(0, 0);
+            startTime = Clock::now();
+
+            queues.reserve(threads);
+            for (int i = 0; i < threads; ++i) {
+                queues.push_back(std::make_unique<WorkerQueue>());
+            }
+            activeWorkers = threads;
+            for (int i = 0; i < threads; ++i) {
+                QtConcurrent::run(pool, [self, i] { self->workerLoop(static_cast<std::size_t>(i)); });
+            }
+        }
+
+        void feed(std::vector<In> items) {
+            if (items.empty()) {
+                return;
+            }
+            auto shared = std::make_shared<const std::vector<In>>(std::move(items));
+            const std::size_t count = shared->size();
+            {
+                std::lock_guard lock(injectMutex);
+                const std::size_t base = totalFed;
+                // 按线程数切分，使空闲线程各自领取一段，减少初期的窃取
+                const std::size_t parts = std::min(queues.size(), count);
+                for (std::size_t p = 0; p < parts; ++p) {
+                    injector.push_back({shared, base, count * p / parts, count * (p + 1) / parts});
+                }
+                totalFed += count;
+                iface.setProgressRange(0, static_cast<int>(totalFed));
+            }
+            injectCv.notify_all();
+        }
+
+        void close() {
+            {
+                std::lock_guard lock(injectMutex);
+                closed = true;
+            }
+            injectCv.notify_all();
+        }
+
+        bool waitForBacklog(std::size_t limit) {
+            std::unique_lock lock(injectMutex);
+            while (totalFed - completed.load() > limit && !iface.isCanceled()) {
+                // completed 在锁外递增，定时醒来兜底可能错过的通知
+                drainCv.wait_for(lock, std::chrono::milliseconds(50));
+            }
+            return !iface.isCanceled();
+        }
+
+        void workerLoop(std::size_t self) {
+            auto &queue = *queues[self];
+            while (!iface.isCanceled()) {
+                Segment chunk;
+                if (takeLocal(queue, chunk) || takeInjected(queue, chunk) || steal(self, chunk)) {
+                    processChunk(queue, chunk);
+                    continue;
+                }
+
+                std::unique_lock lock(injectMutex);
+                if (closed && injector.empty()) {
+                    break; // 无新输入，也没有可窃取的工作
+                }
+                injectCv.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                    return closed || !injector.empty();
+                });
+            }
+
+            if (--activeWorkers == 0) {
+                finish();
+            }
+        }
+
+        /**
+         * @brief 从本地区间头部领取一块，块大小由实测单条耗时决定
+         */
+        bool takeLocal(WorkerQueue &queue, Segment &chunk) {
+            std::lock_guard lock(queue.mutex);
+            if (queue.range.size() == 0) {
+                return false;
+            }
+            std::size_t n = 1;
+            if (queue.nsPerItem > 0) {
+                const auto target = std::chrono::duration<double, std::nano>(options.targetChunkTime).count();
+                n = static_cast<std::size_t>(target / queue.nsPerItem);
+            }
+            n = std::clamp<std::size_t>(n, 1, std::min(options.maxChunkSize, queue.range.size()));
+
+            chunk = queue.range;
+            chunk.end = chunk.begin + n;
+            queue.range.begin += n;
+            return true;
+        }
+
+        bool takeInjected(WorkerQueue &queue, Segment &chunk) {
+            {
+                std::lock_guard lock(injectMutex);
+                if (injector.empty()) {
+                    return false;
+                }
+                std::lock_guard queueLock(queue.mutex);
+                queue.range = std::move(injector.front());
+                injector.pop_front();
+            }
+            return takeLocal(queue, chunk);
+        }
+
+        /**
+         * @brief 从剩余最多的线程尾部窃取一半区间
+         */
+        bool steal(std::size_t self, Segment &chunk) {
+            std::size_t victim = self;
+            std::size_t best = 1;
+            for (std::size_t i = 0; i < queues.size(); ++i) {
+                if (i == self) {
+                    continue;
+                }
+                std::lock_guard lock(queues[i]->mutex);
+                if (queues[i]->range.size() > best) {
+                    best = queues[i]->range.size();
+                    victim = i;
+                }
+            }
+            if (victim == self) {
+                return false;
+            }
+
+            Segment stolen;
+            {
+                std::lock_guard lock(queues[victim]->mutex);
+                auto &range = queues[victim]->range;
+                if (range.size() < 2) {
+                    return false;
+                }
+                stolen = range;
+                stolen.begin = range.end - range.size() / 2;
+                range.end = stolen.begin;
+            }
+
+            auto &queue = *queues[self];
+            {
+                std::lock_guard lock(queue.mutex);
+                queue.range = std::move(stolen);
+            }
+            return takeLocal(queue, chunk);
+        }
+
+        void processChunk(WorkerQueue &queue, const Segment &chunk) {
+            const auto begin = Clock::now();
+
+            QVector<Out> results;
+            try {
+                results = fn(std::span<const In>(chunk.items->data() + chunk.begin, chunk.size()));
+            } catch (const std::exception &e) {
+                spdlog::error("BatchEngine: chunk [{}, {}) failed: {}",
+                              chunk.base + chunk.begin,
+                              chunk.base + chunk.end,
+                              e.what());
+                results.clear();
+            }
+            // 结果数与条目数不符时补齐空结果，保证下标对应
+            results.resize(static_cast<int>(chunk.size()));
+
+            const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+            {
+                std::lock_guard lock(queue.mutex);
+                const double sample = elapsed / static_cast<double>(chunk.size());
+                queue.nsPerItem = queue.nsPerItem > 0 ? queue.nsPerItem * 0.7 + sample * 0.3 : sample;
+            }
+
+            iface.reportResults(results, static_cast<int>(chunk.base + chunk.begin), results.size());
+            completed += chunk.size();
+            drainCv.notify_all();
+            reportProgress(false);
+        }
+
+        /**
+         * @brief 按固定间隔上报进度与剩余时间，force 为 true 时立即上报
+         */
+        void reportProgress(bool force) {
+            const auto now = Clock::now();
+            const auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime).count();
+            const auto intervalNs =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(options.progressInterval).count();
+
+            auto last = lastReportNs.load();
+            if (!force && (nowNs - last < intervalNs || !lastReportNs.compare_exchange_strong(last, nowNs))) {
+                return;
+            }
+
+            const std::size_t done = completed.load();
+            std::size_t total;
+            {
+                std::lock_guard lock(injectMutex);
+                total = totalFed;
+            }
+
+            QString text;
+            if (done > 0 && done < total) {
+                const double remaining = static_cast<double>(nowNs) / static_cast<double>(done) *
+                                         static_cast<double>(total - done) / 1e9;
+                const auto seconds = static_cast<int>(remaining + 0.5);
+                text = QCoreApplication::translate("BatchEngine", "剩余约 %1:%2")
+                           .arg(seconds / 60)
+                           .arg(seconds % 60, 2, 10, QChar('0'));
+            }
+            iface.setProgressValueAndText(static_cast<int>(done), text);
+        }
+
+        void finish() {
+            reportProgress(true);
+            const auto elapsed = std::chrono::duration<double>(Clock::now() - startTime).count();
+            spdlog::info("BatchEngine finished: {} items in {:.3f}s", completed.load(), elapsed);
+            iface.reportFinished();
+        }
+
+        ChunkFunction fn;
+        const EngineOptions options;
+        QFutureInterface<Out> iface;
+        Clock::time_point startTime;
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::atomic_int activeWorkers{0};
+        std::atomic_size_t completed{0};
+        std::atomic<long long> lastReportNs{0};
+
+        std::mutex injectMutex;
+        std::condition_variable injectCv;
+        std::condition_variable drainCv;
+        std::deque<Segment> injector;
+        std::size_t totalFed = 0;
+        bool closed = false;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace batch
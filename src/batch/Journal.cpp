@@ -0,0 +1,169 @@
+#include "Journal.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QSaveFile>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+using json = nlohmann::json;
+
+namespace batch {
+
+namespace {
+
+QByteArray toLine(const JournalRecord &record) {
+    const json line = {
+        {"in", record.input.toStdString()},
+        {"ih", record.inputHash.toStdString()},
+        {"out", record.output.toStdString()},
+        {"oh", record.outputHash.toStdString()},
+        {"st", record.ok ? "ok" : "failed"},
+    };
+    return QByteArray::fromStdString(line.dump()) + '\n';
+}
+
+QByteArray hashFile(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file)) {
+        return {};
+    }
+    return hash.result().toHex();
+}
+
+QByteArray Journal::hashContent(const QByteArray &content, const QByteArray &salt) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(salt);
+    hash.addData(content);
+    return hash.result().toHex();
+}
+
+} // namespace
+
+Journal::Journal(QString directory)
+    : directory_(std::move(directory)), file_(QDir(directory_).filePath(fileName)) {}
+
+std::shared_ptr<Journal> Journal::open(const QString &directory, QString *error) {
+    std::shared_ptr<Journal> journal(new Journal(directory));
+    if (!journal->load(error)) {
+        return nullptr;
+    }
+    return journal;
+}
+
+bool Journal::load(QString *error) {
+    std::size_t lines = 0;
+    if (file_.open(QIODevice::ReadOnly)) {
+        qint64 complete = 0;
+        while (!file_.atEnd()) {
+            const QByteArray line = file_.readLine();
+            if (!line.endsWith('\n')) {
+                break; // 崩溃时写了一半的最后一行
+            }
+            complete = file_.pos();
+            try {
+                const auto value = json::parse(line.constData(), line.constData() + line.size());
+                JournalRecord record;
+                record.input = QString::fromStdString(value.at("in").get<std::string>());
+                record.inputHash = QByteArray::fromStdString(value.at("ih").get<std::string>());
+                record.output = QString::fromStdString(value.at("out").get<std::string>());
+                record.outputHash = QByteArray::fromStdString(value.at("oh").get<std::string>());
+                record.ok = value.at("st").get<std::string>() == "ok";
+                records_.insert(record.input, record);
+                ++lines;
+            } catch (const std::exception &e) { spdlog::warn("Skipping malformed journal line: {}", e.what()); }
+        }
+        const bool truncated = complete < file_.size();
+        file_.close();
+        // 截掉半行，否则后续追加的记录会接在它后面一起损坏
+        if (truncated && !file_.resize(complete)) {
+            spdlog::warn("Cannot truncate partial journal line in {}", path().toStdString());
+        }
+    }
+
+    // 旧记录占大多数时重写为每个输入一行，避免长期运行的日志无限增长
+    if (lines > 1024 && lines > static_cast<std::size_t>(records_.size()) * 2) {
+        QSaveFile compacted(file_.fileName());
+        if (compacted.open(QIODevice::WriteOnly)) {
+            for (const auto &record : std::as_const(records_)) {
+                compacted.write(toLine(record));
+            }
+            if (compacted.commit()) {
+                spdlog::info("Compacted journal {}: {} -> {} lines", path().toStdString(), lines, records_.size());
+            }
+        }
+    }
+
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (error) {
+            *error = file_.errorString();
+        }
+        spdlog::error("Cannot open journal {}: {}", path().toStdString(), file_.errorString().toStdString());
+        return false;
+    }
+    spdlog::info("Opened journal {} with {} entries", path().toStdString(), records_.size());
+    return true;
+}
+
+QByteArray Journal::hashInput(const QString &path, const QByteArray &salt) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(salt);
+    if (!hash.addData(&file)) {
+        return {};
+    }
+    return hash.result().toHex();
+}
+
+std::optional<JournalRecord> Journal::completed(const QString &input, const QByteArray &inputHash) const {
+    if (inputHash.isEmpty()) {
+        return std::nullopt;
+    }
+    JournalRecord record;
+    {
+        std::lock_guard lock(mutex_);
+        const auto it = records_.constFind(input);
+        if (it == records_.cend() || !it->ok || it->inputHash != inputHash) {
+            return std::nullopt;
+        }
+        record = *it;
+    }
+    // 输出文件可能在中断后被删除或只写了一部分
+    if (hashFile(QDir(directory_).filePath(record.output)) != record.outputHash) {
+        spdlog::info("Journal entry for {} is stale, reprocessing", input.toStdString());
+        return std::nullopt;
+    }
+    return record;
+}
+
+void Journal::append(std::span<const JournalRecord> records) {
+    if (records.empty()) {
+        return;
+    }
+    QByteArray lines;
+    for (const auto &record : records) {
+        lines += toLine(record);
+    }
+
+    std::lock_guard lock(mutex_);
+    // 一块记录一次写入并刷新，进程崩溃时最多丢失正在写的这一块
+    if (file_.write(lines) != lines.size() || !file_.flush()) {
+        spdlog::error("Failed to append to journal {}: {}", path().toStdString(), file_.errorString().toStdString());
+    }
+    for (const auto &record : records) {
+        records_.insert(record.input, record);
+    }
+}
+
+QString Journal::path() const {
+    return file_.fileName();
+}
+
+} // namespace batch
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace batch {
+
+/**
+ * @brief 日志中的单条记录
+ */
+struct JournalRecord {
+    QString input;         /**< 输入文件路径 */
+    QByteArray inputHash;  /**< 输入内容与处理参数的 SHA-256（十六进制） */
+    QString output;        /**< 输出文件名，相对输出目录 */
+    QByteArray outputHash; /**< 输出内容的 SHA-256（十六进制） */
+    bool ok = false;       /**< 是否处理成功 */
+};
+
+/**
+ * @class Journal
+ * @brief 保存在输出目录中的只追加任务日志，使中断的批处理在重启后跳过已完成的条目
+ *
+ * 每处理完一块条目追加一行 JSON，输出文件写完之后才写日志，因此崩溃最多导致少量条目被重做。
+ * 重启时同一输入的最后一条记录生效：只有记录成功、输入哈希一致且输出文件的哈希仍与记录相符时才跳过，
+ * 输入被修改、参数变化或输出被删改的条目都会重新处理。
+ * 末尾写了一半的行在加载时忽略；被覆盖的旧记录过多时在打开时压缩日志。
+ */
+class Journal {
+public:
+    static constexpr auto fileName = ".lab2qrcode-journal.jsonl";
+
+    /**
+     * @brief 打开（不存在时创建）输出目录中的日志
+     * @param directory 输出目录
+     * @param error 失败时写入原因，可为空
+     * @return 失败时返回空指针
+     */
+    static std::shared_ptr<Journal> open(const QString &directory, QString *error = nullptr);
+
+    /**
+     * @brief 计算输入的哈希，salt 用于区分处理参数（尺寸、格式、Base64 等）
+     * @return 十六进制 SHA-256，文件无法读取时为空
+     */
+    static QByteArray hashInput(const QString &path, const QByteArray &salt);
+
+    /**
+     * @brief 同 hashInput()，输入已在内存中（如表格中展开的一行）
+     */
+    static QByteArray hashContent(const QByteArray &content, const QByteArray &salt);
+
+    /**
+     * @brief 查询已完成的条目，并校验输出文件的哈希，线程安全
+     * @return 可以跳过时返回对应记录
+     */
+    std::optional<JournalRecord> completed(const QString &input, const QByteArray &inputHash) const;
+
+    /**
+     * @brief 追加一批记录并刷新到磁盘，线程安全
+     */
+    void append(std::span<const JournalRecord> records);
+
+    /**
+     * @brief 日志文件路径
+     */
+    QString path() const;
+
+private:
+    explicit Journal(QString directory);
+
+    bool load(QString *error);
+
+    const QString directory_;
+    QFile file_;
+    QHash<QString, JournalRecord> records_; /**< 每个输入的最后一条记录 */
+    mutable std::mutex mutex_;
+};
+
+} // namespace batch
@@ -0,0 +1,212 @@
+#include "MailMerge.h"
+#include "Journal.h"
+#include "../io/OutputSink.h"
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QSet>
+#include <cstdint>
+#include <functional>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+
+namespace batch {
+
+RowTemplate::RowTemplate(const QString &pattern, const QStringList &header) {
+    QString literal;
+    const auto flush = [&] {
+        if (!literal.isEmpty()) {
+            parts_.push_back({Part::literal, literal});
+            literal.clear();
+        }
+    };
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar ch = pattern[i];
+        if ((ch == '{' || ch == '}') && i + 1 < pattern.size() && pattern[i + 1] == ch) {
+            literal += ch; // {{ 或 }}
+            ++i;
+            continue;
+        }
+        const int close = ch == '{' ? pattern.indexOf('}', i + 1) : -1;
+        if (close < 0) {
+            literal += ch;
+            continue;
+        }
+
+        const QString key = pattern.mid(i + 1, close - i - 1).trimmed();
+        i = close;
+        flush();
+
+        // 列名优先，表头中恰好有名为 row 或数字的列时按列名匹配
+        int column = Part::literal;
+        for (int c = 0; c < header.size(); ++c) {
+            if (header[c].trimmed() == key) {
+                column = c;
+                break;
+            }
+        }
+        bool isIndex = false;
+        const int index = key.toInt(&isIndex);
+        if (column == Part::literal && isIndex && index >= 1) {
+            column = index - 1;
+        } else if (column == Part::literal && key.compare("row", Qt::CaseInsensitive) == 0) {
+            column = Part::rowNumber;
+        }
+
+        if (column == Part::literal) {
+            unknown_.append(key);
+            continue;
+        }
+        parts_.push_back({column, {}});
+    }
+    flush();
+}
+
+QString RowTemplate::expand(const QStringList &row, qint64 rowNumber) const {
+    QString text;
+    for (const auto &part : parts_) {
+        switch (part.column) {
+        case Part::literal: text += part.text; break;
+        case Part::rowNumber: text += QString::number(rowNumber); break;
+        default:
+            if (part.column < row.size()) {
+                text += row[part.column];
+            }
+            break;
+        }
+    }
+    return text;
+}
+
+QString sanitizeOutputName(QString name, qint64 rowNumber, convert::output_format format) {
+    static const QString forbidden = QStringLiteral("/\\:*?\"<>|");
+    for (auto &ch : name) {
+        if (ch.unicode() < 0x20 || forbidden.contains(ch)) {
+            ch = '_';
+        }
+    }
+    name = name.trimmed();
+    if (name.isEmpty()) {
+        name = QString::number(rowNumber);
+    }
+
+    const QString suffix = QFileInfo(name).suffix().toLower();
+    if (format != convert::output_format::png) {
+        const QString vectorSuffix = format == convert::output_format::pdf ? "pdf" : "svg";
+        return suffix == vectorSuffix ? name : name + '.' + vectorSuffix;
+    }
+
+    static const QSet<QByteArray> writable = [] {
+        QSet<QByteArray> formats;
+        for (const auto &imageFormat : QImageWriter::supportedImageFormats()) {
+            formats.insert(imageFormat);
+        }
+        return formats;
+    }();
+    if (!writable.contains(suffix.toLatin1())) {
+        name += QStringLiteral(".png");
+    }
+    return name;
+}
+
+QString UniqueNames::claim(const QString &name) {
+    const std::size_t first = key(name);
+    if (next_.try_emplace(first, 2).second) {
+        return name;
+    }
+
+    const int dot = name.lastIndexOf('.');
+    const QString base = dot > 0 ? name.left(dot) : name;
+    const QString suffix = dot > 0 ? name.mid(dot) : QString();
+    for (;;) {
+        // 每次重新查找：插入新文件名可能使迭代器失效
+        const int n = next_[first]++;
+        QString candidate = QStringLiteral("%1_%2%3").arg(base).arg(n).arg(suffix);
+        if (next_.try_emplace(key(candidate), 2).second) {
+            spdlog::debug("Output name {} already used, writing {}", name.toStdString(), candidate.toStdString());
+            return candidate;
+        }
+    }
+}
+
+std::size_t UniqueNames::key(const QString &name) {
+    const QString folded = name.toCaseFolded();
+    const std::u16string_view text(reinterpret_cast<const char16_t *>(folded.utf16()),
+                                   static_cast<std::size_t>(folded.size()));
+    return std::hash<std::u16string_view>{}(text);
+}
+
+QVector<SaveResult> MergeWorker::operator()(std::span<const MergeRow> rows) const {
+    QVector<SaveResult> results(static_cast<int>(rows.size()));
+    std::vector<SaveTask> tasks;
+    std::vector<int> indices;
+    std::vector<JournalRecord> records; // 未跳过的行，生成失败的保持 ok = false
+    std::vector<std::size_t> taskRecords;
+    tasks.reserve(rows.size());
+    indices.reserve(rows.size());
+
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto &row = rows[i];
+        const QString &dest = row.dest;
+        const QByteArray data = payload->expand(row.cells, row.row).toUtf8();
+        if (journal) {
+            // 内容与文件名都参与哈希，表格改动后同一行号的旧输出不会被误认为已完成
+            QByteArray hash = Journal::hashContent(data + '\0' + dest.toUtf8(), salt);
+            const QString key = QStringLiteral("row:%1").arg(row.row);
+            if (journal->completed(key, hash)) {
+                results[static_cast<int>(i)] = {SaveResult::skipped, dest};
+                continue;
+            }
+            records.push_back({key, std::move(hash), dest, {}, false});
+        }
+        try {
+            std::string text;
+            auto entry = generate.encode(dest,
+                                         reinterpret_cast<const std::uint8_t *>(data.constData()),
+                                         static_cast<std::size_t>(data.size()),
+                                         generate.verify ? &text : nullptr);
+            if (!entry) {
+                results[static_cast<int>(i)] = {SaveResult::invalid_data, dest};
+                continue;
+            }
+            if (generate.verify) {
+                entry.verified = generate.check(entry, text);
+            }
+            tasks.push_back({std::move(entry), dest});
+            indices.push_back(static_cast<int>(i));
+            if (journal) {
+                taskRecords.push_back(records.size() - 1);
+            }
+        } catch (const std::exception &e) {
+            spdlog::warn("表格第 {} 行生成失败: {}", row.row, e.what());
+            results[static_cast<int>(i)] = {SaveResult::invalid_data, dest};
+        }
+    }
+
+    std::vector<QByteArray> digests;
+    const auto saved = SaveWorker{sink, png}.save(tasks, journal ? &digests : nullptr);
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        auto &res = results[indices[k]];
+        res = saved[static_cast<int>(k)];
+        if (res.err == SaveResult::success && tasks[k].entry.verified == convert::verify_status::failed) {
+            res.err = SaveResult::unverified;
+        }
+        if (journal) {
+            auto &record = records[taskRecords[k]];
+            record.outputHash = digests[k];
+            record.ok = res.err == SaveResult::success;
+        }
+        if (res.err == SaveResult::success) {
+            res.path.clear();
+        }
+    }
+
+    // 输出写完之后才记日志，中途崩溃最多重做这一块
+    if (journal) {
+        journal->append(records);
+    }
+    return results;
+}
+
+} // namespace batch
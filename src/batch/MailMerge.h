@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Workers.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace io {
+class OutputSink;
+} // namespace io
+
+namespace batch {
+
+/**
+ * @brief 表格中的一行数据
+ */
+struct MergeRow {
+    qint64 row = 0;    /**< 数据行号，从 1 开始 */
+    QStringList cells; /**< 按表头顺序的单元格 */
+    QString dest;      /**< 输出文件名，读取表格时按行序展开并去重 */
+};
+
+/**
+ * @class RowTemplate
+ * @brief 按表头把模板中的占位符替换为一行的单元格
+ *
+ * 支持 {列名}、{列序号}（从 1 开始）和 {row}（数据行号），{{ 和 }} 表示字面的花括号。
+ * 模板在构造时解析一次，展开时只做拼接。
+ */
+class RowTemplate {
+public:
+    RowTemplate(const QString &pattern, const QStringList &header);
+
+    QString expand(const QStringList &row, qint64 rowNumber) const;
+
+    /**
+     * @brief 表头中找不到的占位符，展开时替换为空
+     */
+    const QStringList &unknownColumns() const noexcept {
+        return unknown_;
+    }
+
+private:
+    /**
+     * @brief 字面文本（literal）、行号（rowNumber）或第 column 列的单元格
+     */
+    struct Part {
+        static constexpr int literal = -1;
+        static constexpr int rowNumber = -2;
+
+        int column = literal;
+        QString text;
+    };
+
+    std::vector<Part> parts_;
+    QStringList unknown_;
+};
+
+/**
+ * @brief 把展开后的文件名中的路径分隔符和 Windows 不允许的字符替换为下划线
+ *
+ * 为空时使用行号。PNG 输出时后缀不是可写的图片格式则补 .png，矢量输出时后缀不是 .svg/.pdf 则补上。
+ */
+QString sanitizeOutputName(QString name, qint64 rowNumber, convert::output_format format = convert::output_format::png);
+
+/**
+ * @class UniqueNames
+ * @brief 一次表格批量生成中已使用的输出文件名，重名时在后缀前追加序号（name_2.png）
+ *
+ * 只在读取表格的线程上按行序调用，同一张表格重新生成时每行得到的文件名不变。
+ * 比较不区分大小写，Windows 上只差大小写的文件名同样会互相覆盖。
+ * 只保存文件名的 64 位哈希，百万行的批次也只占几十 MB；哈希碰撞只会多追加一个序号。
+ */
+class UniqueNames {
+public:
+    /**
+     * @brief 占用文件名，已被占用时返回追加了序号的新文件名
+     */
+    QString claim(const QString &name);
+
+private:
+    static std::size_t key(const QString &name);
+
+    std::unordered_map<std::size_t, int> next_; /**< 已占用文件名的哈希 -> 重名时尝试的下一个序号 */
+};
+
+/**
+ * @brief 表格批量生成的工作函数：在工作线程上展开内容模板、生成条码并按行中的文件名直接写入输出目标
+ *
+ * 成功的行只回报状态，不保留文件名和图片，百万行的批次结果也只占很少的内存。
+ * 设置了任务日志时以行号为键、内容与文件名的哈希为输入哈希记录，中断后重新生成同一张表格时，
+ * 内容、文件名和参数都未变且输出未被改动的行在生成前跳过，标记为 skipped。
+ */
+struct MergeWorker {
+    using result_type = SaveResult;
+
+    GenerateWorker generate;
+    std::shared_ptr<io::OutputSink> sink;
+    std::shared_ptr<const RowTemplate> payload; /**< 条码内容模板，展开后按 UTF-8 编码 */
+    io::PngOptions png;                         /**< PNG 输出的压缩参数 */
+    std::shared_ptr<Journal> journal;           /**< 输出目录中的任务日志，可为空 */
+    QByteArray salt;                            /**< 生成参数的摘要，参数变化后不复用旧的输出 */
+
+    QVector<SaveResult> operator()(std::span<const MergeRow> rows) const;
+};
+
+} // namespace batch
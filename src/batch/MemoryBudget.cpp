@@ -0,0 +1,113 @@
+#include "MemoryBudget.h"
+#include "../io/MappedInput.h"
+#include <QBuffer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace batch {
+
+MemoryBudget::Permit::Permit(Permit &&other) noexcept
+    : budget_(std::exchange(other.budget_, nullptr)), bytes_(std::exchange(other.bytes_, 0)) {}
+
+MemoryBudget::Permit &MemoryBudget::Permit::operator=(Permit &&other) noexcept {
+    if (this != &other) {
+        release();
+        budget_ = std::exchange(other.budget_, nullptr);
+        bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+}
+
+MemoryBudget::Permit::~Permit() {
+    release();
+}
+
+void MemoryBudget::Permit::release() noexcept {
+    if (budget_) {
+        budget_->release(bytes_);
+        budget_ = nullptr;
+        bytes_ = 0;
+    }
+}
+
+MemoryBudget::MemoryBudget(std::size_t limitBytes)
+    : limit_(std::max<std::size_t>(limitBytes, 1)) {}
+
+MemoryBudget::Permit MemoryBudget::acquire(std::size_t bytes) {
+    // 单个任务超过总预算时按总预算计，等其他任务全部完成后独占执行
+    bytes = std::min(bytes, limit_);
+
+    std::unique_lock lock(mutex_);
+    if (inFlight_ > 0 && inFlight_ + bytes > limit_) {
+        spdlog::debug("MemoryBudget: waiting for {} bytes, in flight {}/{}", bytes, inFlight_, limit_);
+        cv_.wait(lock, [&] { return inFlight_ == 0 || inFlight_ + bytes <= limit_; });
+    }
+    inFlight_ += bytes;
+    return {this, bytes};
+}
+
+std::optional<MemoryBudget::Permit> MemoryBudget::tryAcquire(std::size_t bytes) {
+    bytes = std::min(bytes, limit_);
+
+    std::lock_guard lock(mutex_);
+    if (inFlight_ > 0 && inFlight_ + bytes > limit_) {
+        return std::nullopt;
+    }
+    inFlight_ += bytes;
+    return Permit{this, bytes};
+}
+
+std::size_t MemoryBudget::inFlight() const {
+    std::lock_guard lock(mutex_);
+    return inFlight_;
+}
+
+void MemoryBudget::release(std::size_t bytes) noexcept {
+    {
+        std::lock_guard lock(mutex_);
+        inFlight_ -= bytes;
+    }
+    cv_.notify_all();
+}
+
+std::size_t estimateGenerateBytes(long long fileSize, bool useBase64, int width, int height) {
+    const auto size = static_cast<std::size_t>(std::max(fileSize, 0LL));
+    // 小文件读入内存一份，大文件为映射不计；文本副本一份（Base64 膨胀 4/3）+ ZXing 编码时的内部副本
+    const std::size_t input = fileSize < io::kMapThreshold ? size : 0;
+    const std::size_t text = useBase64 ? (size + 2) / 3 * 4 : size;
+    const std::size_t image =
+        static_cast<std::size_t>(std::max(width, 0)) * static_cast<std::size_t>(std::max(height, 0));
+    return input + text * 2 + image * 2;
+}
+
+std::size_t estimateDecodeBytes(const QString &filePath) {
+    const auto fileSize = static_cast<std::size_t>(std::max<qint64>(QFileInfo(filePath).size(), 0));
+
+    const QSize dims = QImageReader(filePath).size();
+    if (!dims.isValid()) {
+        return fileSize * 8;
+    }
+    // imread 的 BGR 原图 + cvtColor 后的灰度图 + 压缩数据本身
+    const auto pixels = static_cast<std::size_t>(dims.width()) * static_cast<std::size_t>(dims.height());
+    return fileSize + pixels * 4;
+}
+
+std::size_t estimateDecodeBytes(const QByteArray &encoded) {
+    const auto fileSize = static_cast<std::size_t>(encoded.size());
+
+    QBuffer buffer;
+    buffer.setData(encoded);
+    buffer.open(QIODevice::ReadOnly);
+    const QSize dims = QImageReader(&buffer).size();
+    if (!dims.isValid()) {
+        return fileSize * 8;
+    }
+    // 数据已在内存中，imdecode 直接输出灰度图
+    const auto pixels = static_cast<std::size_t>(dims.width()) * static_cast<std::size_t>(dims.height());
+    return pixels;
+}
+
+} // namespace batch
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+class QByteArray;
+class QString;
+
+namespace batch {
+
+/**
+ * @class MemoryBudget
+ * @brief 按字节计数的准入控制器
+ *
+ * 每个批处理任务在读取输入前先申请其预估的内存占用，
+ * 只有在途总量不超过预算时才放行，从而避免多个大文件同时处理把内存耗尽。
+ * 当没有任何在途任务时，超出预算的单个任务也会被放行，保证不会死锁。
+ */
+class MemoryBudget {
+public:
+    /**
+     * @class Permit
+     * @brief RAII 许可，析构时归还申请的字节数
+     */
+    class Permit {
+    public:
+        Permit() = default;
+        Permit(Permit &&other) noexcept;
+        Permit &operator=(Permit &&other) noexcept;
+        Permit(const Permit &) = delete;
+        Permit &operator=(const Permit &) = delete;
+        ~Permit();
+
+        /**
+         * @brief 提前归还许可
+         */
+        void release() noexcept;
+
+        std::size_t bytes() const noexcept {
+            return bytes_;
+        }
+
+    private:
+        friend class MemoryBudget;
+        Permit(MemoryBudget *budget, std::size_t bytes) noexcept
+            : budget_(budget), bytes_(bytes) {}
+
+        MemoryBudget *budget_ = nullptr;
+        std::size_t bytes_ = 0;
+    };
+
+    explicit MemoryBudget(std::size_t limitBytes);
+
+    /**
+     * @brief 申请内存许可，预算不足时阻塞等待
+     * @param bytes 预估占用的字节数
+     * @return 持有该字节数的许可
+     */
+    [[nodiscard]] Permit acquire(std::size_t bytes);
+
+    /**
+     * @brief 不等待的 acquire，预算不足时返回空
+     *
+     * 供已持有许可、又要继续申请的调用方使用：持有许可时阻塞等待可能永远等不到。
+     */
+    [[nodiscard]] std::optional<Permit> tryAcquire(std::size_t bytes);
+
+    std::size_t limit() const noexcept {
+        return limit_;
+    }
+
+    std::size_t inFlight() const;
+
+private:
+    void release(std::size_t bytes) noexcept;
+
+    const std::size_t limit_;
+    std::size_t inFlight_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+/**
+ * @brief 估算生成条码时单个文件的峰值内存
+ *
+ * 包含小文件读入的原始数据（大文件为内存映射不计）、Base64/字符串副本、ZXing 内部副本以及生成和缩放后的两张灰度图。
+ * @param fileSize 输入文件大小（字节）
+ * @param useBase64 是否进行 Base64 编码
+ * @param width 目标图片宽度（像素）
+ * @param height 目标图片高度（像素）
+ */
+std::size_t estimateGenerateBytes(long long fileSize, bool useBase64, int width, int height);
+
+/**
+ * @brief 估算解码单张图片的峰值内存
+ *
+ * 通过 QImageReader 仅读取图片头获得尺寸，按 BGR 原图加灰度图计算；无法读取尺寸时按文件大小放大估算。
+ * @param filePath 图片路径
+ */
+std::size_t estimateDecodeBytes(const QString &filePath);
+
+/**
+ * @brief 估算解码已读入内存的图片的峰值内存，直接解码为灰度图
+ * @param encoded 图片文件内容
+ */
+std::size_t estimateDecodeBytes(const QByteArray &encoded);
+
+} // namespace batch
@@ -0,0 +1,625 @@
+#include "Workers.h"
+#include "Journal.h"
+#include "../io/ArchiveReader.h"
+#include "../io/BulkFileIO.h"
+#include "../io/DirectoryWalker.h"
+#include "../io/MappedInput.h"
+#include "../io/OutputSink.h"
+#include "../io/VectorWriter.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <SimpleBase64.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <spdlog/spdlog.h>
+#include <utility>
+#include <vector>
+
+namespace batch {
+
+namespace {
+
+// 这些工作函数原先定义在 BarcodeWidget 中，沿用其翻译上下文
+QString tr(const char *text) {
+    return QCoreApplication::translate("BarcodeWidget", text);
+}
+
+void setResolution(QImage &img, int ppi) {
+    const int dpm = static_cast<int>(ppi / 0.0254);
+    img.setDotsPerMeterX(dpm);
+    img.setDotsPerMeterY(dpm);
+}
+
+/**
+ * @brief 矢量输出只保留模块矩阵，不按打印尺寸栅格化大图，data 中放一张小尺寸预览
+ */
+void setVectorData(convert::result_data_entry &res,
+                   ZXing::BitMatrix bits,
+                   int width,
+                   int height,
+                   int ppi,
+                   convert::output_format output) {
+    auto modules = std::make_shared<convert::barcode_modules>();
+    modules->bits = std::move(bits);
+    modules->width_mm = width * 25.4 / ppi;
+    modules->height_mm = height * 25.4 / ppi;
+    modules->format = output;
+
+    // 预览按整数倍放大到约 256 像素宽，高度按物理尺寸的宽高比（一维码的矩阵只有一行）
+    static constexpr int previewWidth = 256;
+    const int scaleX = std::max(1, previewWidth / std::max(modules->bits.width(), 1));
+    const double previewHeight = modules->bits.width() * scaleX * modules->height_mm / modules->width_mm;
+    const int scaleY = std::max(1, static_cast<int>(previewHeight) / std::max(modules->bits.height(), 1));
+    auto preview = convert::bitmatrix_to_qimage(modules->bits, scaleX, scaleY);
+    const int dpm = static_cast<int>(preview.width() / (modules->width_mm / 1000));
+    preview.setDotsPerMeterX(dpm);
+    preview.setDotsPerMeterY(dpm);
+
+    res.data = std::move(preview);
+    res.modules = std::move(modules);
+}
+
+/**
+ * @brief 解码结果中的每张图片并与编码前的内容比较，矢量输出校验其预览
+ */
+convert::verify_status
+verifyEntry(const convert::result_data_entry &entry, const std::string &text, ZXing::BarcodeFormat format) {
+    const auto passed = [&](const convert::result_data_entry &item) {
+        const auto *img = std::get_if<QImage>(&item.data);
+        return img && convert::verify_qimage(*img, text, format);
+    };
+    const bool ok = entry.renditions.empty() ? passed(entry) : std::ranges::all_of(entry.renditions, passed);
+    if (!ok) {
+        spdlog::warn("生成结果校验失败: {}", entry.source_file_name.toStdString());
+    }
+    return ok ? convert::verify_status::passed : convert::verify_status::failed;
+}
+
+/**
+ * @brief 生成结果在任务日志中的键：输入文件，多份输出时每份加上配置名
+ */
+QString journalKey(const QString &source, const QString &profile) {
+    return profile.isEmpty() ? source : source + '|' + profile;
+}
+
+/**
+ * @brief 记下输入的哈希，保存时以此记录任务日志
+ */
+void stampInputHash(convert::result_data_entry &entry, const QByteArray &hash) {
+    entry.input_hash = hash;
+    for (auto &rendition : entry.renditions) {
+        rendition.input_hash = hash;
+    }
+}
+
+/**
+ * @brief 任务日志中已完成的输入，不带数据，不参与保存
+ */
+convert::result_data_entry completedEntry(const QString &filePath) {
+    convert::result_data_entry entry;
+    entry.source_file_name = filePath;
+    entry.completed = true;
+    return entry;
+}
+
+/**
+ * @brief 校验专用线程池，批处理引擎的工作线程提交校验后继续编码，不与引擎争用同一个线程池
+ */
+QThreadPool &verifyPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+convert::result_data_entry GenerateWorker::operator()(const QString &filePath) const {
+    QByteArray hash;
+    if (completed(filePath, hash)) {
+        return completedEntry(filePath);
+    }
+    std::string text;
+    auto res = generate(filePath, &text);
+    if (verify && res) {
+        res.verified = check(res, text);
+    }
+    stampInputHash(res, hash);
+    return res;
+}
+
+bool GenerateWorker::completed(const QString &filePath, QByteArray &hash) const {
+    hash.clear();
+    if (!journal || archives->isEntry(filePath)) {
+        return false;
+    }
+    hash = Journal::hashInput(filePath, salt);
+    if (!profiles || profiles->empty()) {
+        return journal->completed(journalKey(filePath, {}), hash).has_value();
+    }
+    return std::ranges::all_of(*profiles, [&](const RenderProfile &profile) {
+        return journal->completed(journalKey(filePath, profile.name), hash).has_value();
+    });
+}
+
+convert::verify_status GenerateWorker::check(const convert::result_data_entry &entry, const std::string &text) const {
+    return verifyEntry(entry, text, format);
+}
+
+QVector<convert::result_data_entry> GenerateWorker::operator()(std::span<const QString> filePaths) const {
+    static constexpr qint64 bulkReadLimit = io::kMapThreshold - 1;
+    QVector<convert::result_data_entry> results(static_cast<int>(filePaths.size()));
+
+    // 先按任务日志跳过已完成的文件，中断后重新生成同一批文件时只处理未完成的
+    std::vector<QByteArray> hashes(filePaths.size());
+    std::vector<bool> pending(filePaths.size(), true);
+    std::vector<QString> diskPaths;
+    diskPaths.reserve(filePaths.size());
+    for (std::size_t i = 0; i < filePaths.size(); ++i) {
+        if (completed(filePaths[i], hashes[i])) {
+            results[static_cast<int>(i)] = completedEntry(filePaths[i]);
+            pending[i] = false;
+        } else if (!archives->isEntry(filePaths[i])) {
+            diskPaths.push_back(filePaths[i]);
+        }
+    }
+
+    // 批量读入前按文件大小为整块原始数据申请预算，超过上限的文件不会被读入
+    std::size_t rawBytes = 0;
+    for (const auto &path : diskPaths) {
+        if (const qint64 size = QFileInfo(path).size(); size <= bulkReadLimit) {
+            rawBytes += static_cast<std::size_t>(std::max<qint64>(size, 0));
+        }
+    }
+    auto permit = budget->acquire(rawBytes);
+    auto blobs = io::BulkFileIO::readFiles(diskPaths, bulkReadLimit);
+
+    // 校验在独立线程池中进行，与本线程上后续条目的编码重叠，块结束时收集
+    std::vector<std::pair<int, QFuture<convert::verify_status>>> checks;
+    const auto submitCheck = [&](int index, std::string text) {
+        if (verify && results[index]) {
+            checks.emplace_back(index,
+                                QtConcurrent::run(&verifyPool(),
+                                                  [entry = results[index], text = std::move(text), format = format] {
+                                                      return verifyEntry(entry, text, format);
+                                                  }));
+        }
+    };
+
+    std::vector<std::size_t> fallback;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < filePaths.size(); ++i) {
+        const auto &filePath = filePaths[i];
+        if (!pending[i]) {
+            continue;
+        }
+        if (archives->isEntry(filePath)) {
+            fallback.push_back(i);
+            continue;
+        }
+        auto &blob = blobs[next++];
+        if (blob.status != io::FileBlob::ok) {
+            fallback.push_back(i);
+            continue;
+        }
+        // 换成剩余原始数据加本条生成的许可（估算已含本条的原始数据）；
+        // 先归还再申请，不在持有许可时等待，避免各线程互相占着预算而死锁
+        const auto size = static_cast<std::size_t>(blob.data.size());
+        rawBytes -= std::min(rawBytes, size);
+        permit.release();
+        permit = budget->acquire(rawBytes + estimate(size));
+        std::string text;
+        try {
+            const auto &data = blob.data;
+            results[static_cast<int>(i)] = render(filePath,
+                                                  reinterpret_cast<const std::uint8_t *>(data.constData()),
+                                                  static_cast<std::size_t>(data.size()),
+                                                  &text);
+        } catch (const std::exception &e) { results[static_cast<int>(i)] = {filePath, std::string(e.what())}; }
+        blob.data = QByteArray();
+        stampInputHash(results[static_cast<int>(i)], hashes[i]);
+        submitCheck(static_cast<int>(i), std::move(text));
+    }
+    permit.release();
+
+    // 归档条目、过大或读取失败的文件逐个处理，各自申请预算
+    for (const auto i : fallback) {
+        std::string text;
+        results[static_cast<int>(i)] = generate(filePaths[i], &text);
+        stampInputHash(results[static_cast<int>(i)], hashes[i]);
+        submitCheck(static_cast<int>(i), std::move(text));
+    }
+
+    for (auto &[index, check] : checks) {
+        results[index].verified = check.result();
+    }
+    return results;
+}
+
+convert::result_data_entry GenerateWorker::generate(const QString &filePath, std::string *text) const {
+    try {
+        if (archives->isEntry(filePath)) {
+            // 归档条目在当前工作线程上解压，与其他线程的编码并行
+            QString error;
+            const auto data = archives->read(filePath, &error);
+            if (!data) {
+                return {filePath, QString(tr("无法读取归档条目: %1")).arg(error).toStdString()};
+            }
+            return encode(filePath,
+                          reinterpret_cast<const std::uint8_t *>(data->constData()),
+                          static_cast<std::size_t>(data->size()),
+                          text);
+        }
+
+        // 大文件直接映射，不经过 readAll 的中间拷贝
+        const auto input = io::MappedInput::open(filePath);
+        if (!input.isOpen()) {
+            return {filePath, QString(tr("无法打开文件: ")).toStdString() + filePath.toStdString()};
+        }
+        return encode(filePath, input.data(), input.size(), text);
+    } catch (const std::exception &e) { return {filePath, std::string(e.what())}; }
+}
+
+std::size_t GenerateWorker::estimate(std::size_t size) const {
+    // 多份输出时按所有配置的像素总数估算
+    int estimateWidth = finalWidth;
+    int estimateHeight = finalHeight;
+    if (profiles && !profiles->empty()) {
+        long long pixels = 0;
+        for (const auto &profile : *profiles) {
+            pixels += static_cast<long long>(profile.width) * profile.height;
+        }
+        estimateWidth = static_cast<int>(std::min<long long>(pixels, std::numeric_limits<int>::max()));
+        estimateHeight = 1;
+    }
+    return estimateGenerateBytes(static_cast<long long>(size), useBase64, estimateWidth, estimateHeight);
+}
+
+convert::result_data_entry
+GenerateWorker::encode(const QString &filePath, const std::uint8_t *data, std::size_t size, std::string *text) const {
+    // 预算不足时在此等待，直到其他任务释放内存
+    const auto permit = budget->acquire(estimate(size));
+    return render(filePath, data, size, text);
+}
+
+convert::result_data_entry
+GenerateWorker::render(const QString &filePath, const std::uint8_t *data, std::size_t size, std::string *text) const {
+    convert::result_data_entry res;
+    res.source_file_name = filePath;
+
+
+    // 是否base64处理通过判断base64CheckBox，编码结果直接交给 ZXing
+    const std::string content = io::encodeTransport(data, size, useBase64);
+    if (text) {
+        *text = content;
+    }
+
+    if (profiles && !profiles->empty()) {
+        // 条码只编码一次，每个配置从同一个模块矩阵栅格化或输出矢量
+        const auto bits = convert::byte_to_QRCode_modules(content, format);
+        for (const auto &profile : *profiles) {
+            convert::result_data_entry rendition;
+            rendition.source_file_name = filePath;
+            rendition.profile = profile.name;
+            if (profile.format != convert::output_format::png) {
+                setVectorData(rendition, bits.copy(), profile.width, profile.height, profile.ppi, profile.format);
+            } else {
+                auto img = convert::resizeImageToExactSize(
+                    convert::inflate_modules(bits, profile.width, profile.height), profile.width, profile.height);
+                setResolution(img, profile.ppi);
+                rendition.data = std::move(img);
+            }
+            res.renditions.push_back(std::move(rendition));
+        }
+        res.data = res.renditions.front().data;
+        res.modules = res.renditions.front().modules;
+        return res;
+    }
+
+    if (output != convert::output_format::png) {
+        setVectorData(res, convert::byte_to_QRCode_modules(content, format), finalWidth, finalHeight, targePPI, output);
+        return res;
+    }
+
+    auto img = convert::byte_to_QRCode_qimage(
+        content, {.target_width = reqWidth, .target_height = reqHeight, .format = format, .margin = 1});
+
+    if (!img.isNull()) {
+        // 缩放图像到精确尺寸
+        img = convert::resizeImageToExactSize(img, finalWidth, finalHeight);
+
+        // 设置图像DPI/DPM元数据
+        setResolution(img, targePPI);
+
+        res.data = img;
+    } else {
+        res.data = QString(tr("生成图片失败")).toStdString();
+    }
+
+    return res;
+}
+
+convert::result_data_entry DecodeWorker::operator()(QString path) const {
+    try {
+        if (archives->isEntry(path)) {
+            QString error;
+            const auto data = archives->read(path, &error);
+            if (!data) {
+                return {std::move(path), QString(tr("无法读取归档条目: %1")).arg(error).toStdString()};
+            }
+            const auto permit = budget->acquire(estimateDecodeBytes(*data));
+            return toEntry(std::move(path), convert::QRcode_to_byte(*data));
+        }
+
+        const auto permit = budget->acquire(estimateDecodeBytes(path));
+        const auto file_path = path.toLocal8Bit().toStdString();
+        return toEntry(std::move(path), convert::QRcode_to_byte(file_path));
+    } catch (const std::exception &e) {
+        return {std::move(path), QString("解码失败:\n%1").arg(e.what()).toStdString()};
+    }
+}
+
+QVector<convert::result_data_entry> DecodeWorker::operator()(std::span<const QString> paths) const {
+    static constexpr qint64 bulkReadLimit = 4 * 1024 * 1024;
+    std::vector<QString> diskPaths;
+    diskPaths.reserve(paths.size());
+    std::ranges::copy_if(
+        paths, std::back_inserter(diskPaths), [this](const QString &path) { return !archives->isEntry(path); });
+
+    // 批量读入前按文件大小为整块原始数据申请预算，超过上限的文件不会被读入
+    std::size_t rawBytes = 0;
+    for (const auto &path : diskPaths) {
+        if (const qint64 size = QFileInfo(path).size(); size <= bulkReadLimit) {
+            rawBytes += static_cast<std::size_t>(std::max<qint64>(size, 0));
+        }
+    }
+    auto permit = budget->acquire(rawBytes);
+    auto blobs = io::BulkFileIO::readFiles(diskPaths, bulkReadLimit);
+
+    QVector<convert::result_data_entry> results(static_cast<int>(paths.size()));
+    std::vector<std::size_t> fallback;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const auto &path = paths[i];
+        if (archives->isEntry(path)) {
+            fallback.push_back(i);
+            continue;
+        }
+        auto &blob = blobs[next++];
+        if (blob.status != io::FileBlob::ok) {
+            fallback.push_back(i);
+            continue;
+        }
+        // 换成剩余原始数据加本张解码的许可；先归还再申请，不在持有许可时等待，避免各线程互相占着预算而死锁
+        const auto size = static_cast<std::size_t>(blob.data.size());
+        const auto decodeBytes = estimateDecodeBytes(blob.data);
+        permit.release();
+        permit = budget->acquire(rawBytes + decodeBytes);
+        try {
+            results[static_cast<int>(i)] = toEntry(path, convert::QRcode_to_byte(blob.data));
+        } catch (const std::exception &e) {
+            results[static_cast<int>(i)] = {path, QString("解码失败:\n%1").arg(e.what()).toStdString()};
+        }
+        blob.data = QByteArray();
+        rawBytes -= std::min(rawBytes, size);
+    }
+    permit.release();
+
+    // 归档条目、过大或读取失败的文件逐个处理，各自申请预算
+    for (const auto i : fallback) {
+        results[static_cast<int>(i)] = (*this)(paths[i]);
+    }
+    return results;
+}
+
+convert::result_data_entry DecodeWorker::toEntry(QString path, const convert::result_i2t &rst) const {
+    switch (rst.err) {
+    case convert::result_i2t::empty_img:
+        spdlog::error("cv::imread 无法加载图片文件: {}", path.toStdString());
+        return {std::move(path), QString{tr("无法加载图片文件: %1")}.arg(path).toStdString()};
+    case convert::result_i2t::invalid_qrcode:
+        return {std::move(path), QString{tr("无法识别条码或条码格式不正确")}.toStdString()};
+    default:
+        std::vector<std::uint8_t> decodedData;
+        if (useBase64) {
+            decodedData = SimpleBase64::decode(rst.text);
+        } else {
+            decodedData = std::vector<std::uint8_t>(rst.text.begin(), rst.text.end());
+        }
+        return {std::move(path),
+                QByteArray(reinterpret_cast<const char *>(decodedData.data()), static_cast<int>(decodedData.size()))};
+    }
+}
+
+QVector<SaveResult> SaveWorker::operator()(std::span<const SaveTask> chunk) const {
+    return save(chunk, nullptr);
+}
+
+QVector<SaveResult> SaveWorker::save(std::span<const SaveTask> chunk, std::vector<QByteArray> *digests) const {
+    // 结果与任务一一对应，编码成功的整块交给输出目标
+    QVector<SaveResult> results(static_cast<int>(chunk.size()));
+    std::vector<io::OutputItem> items;
+    std::vector<int> indices;
+    items.reserve(chunk.size());
+    indices.reserve(chunk.size());
+    if (digests) {
+        digests->assign(chunk.size(), {});
+    }
+
+    std::vector<QString> keys;
+    std::vector<QByteArray> hashes;
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+        const auto &task = chunk[i];
+        // 带输入哈希的生成结果按输入判断，已完成的连编码也省掉
+        const bool byInput = journal && !task.entry.input_hash.isEmpty();
+        const QString key = byInput ? journalKey(task.entry.source_file_name, task.entry.profile) : task.dest;
+        if (byInput && journal->completed(key, task.entry.input_hash)) {
+            results[static_cast<int>(i)] = {SaveResult::skipped, task.dest};
+            continue;
+        }
+        QByteArray bytes;
+        results[static_cast<int>(i)] = {encode(task, bytes, png), task.dest};
+        if (results[static_cast<int>(i)].err != SaveResult::success) {
+            continue;
+        }
+        if (journal) {
+            QByteArray hash = byInput ? task.entry.input_hash
+                                      : QCryptographicHash::hash(bytes, QCryptographicHash::Sha256).toHex();
+            if (!byInput && journal->completed(key, hash)) {
+                results[static_cast<int>(i)].err = SaveResult::skipped;
+                continue;
+            }
+            keys.push_back(key);
+            hashes.push_back(std::move(hash));
+        }
+        items.push_back({task.dest, std::move(bytes), task.entry.source_file_name});
+        indices.push_back(static_cast<int>(i));
+    }
+
+    const auto errors = sink->write(items);
+    std::vector<JournalRecord> records;
+    records.reserve(journal ? items.size() : 0);
+    for (std::size_t k = 0; k < errors.size(); ++k) {
+        QByteArray digest;
+        if (errors[k] != 0) {
+            spdlog::error("写入文件失败: {} ({})", items[k].name.toStdString(), std::strerror(errors[k]));
+            results[indices[k]].err = SaveResult::failed;
+        } else if (digests || journal) {
+            digest = QCryptographicHash::hash(items[k].data, QCryptographicHash::Sha256).toHex();
+        }
+        if (digests) {
+            (*digests)[indices[k]] = digest;
+        }
+        if (journal) {
+            records.push_back({keys[k], hashes[k], items[k].name, std::move(digest), errors[k] == 0});
+        }
+    }
+
+    // 输出写完之后才记日志，中途崩溃最多重写这一块
+    if (journal) {
+        journal->append(records);
+    }
+    return results;
+}
+
+SaveResult::errcode SaveWorker::encode(const SaveTask &task, QByteArray &out, const io::PngOptions &png) noexcept try {
+    if (const auto *img = std::get_if<QImage>(&task.entry.data)) {
+        if (img->isNull()) {
+            return SaveResult::invalid_data;
+        }
+        const QString suffix = QFileInfo(task.dest).suffix().toLower();
+        if (const auto &modules = task.entry.modules) {
+            const QSizeF size(modules->width_mm, modules->height_mm);
+            if (suffix == "svg") {
+                out = io::VectorWriter::toSvg(modules->bits, size);
+                return SaveResult::success;
+            }
+            if (suffix == "pdf") {
+                out = io::VectorWriter::toPdf(modules->bits, size);
+                return SaveResult::success;
+            }
+        }
+        if (suffix == "png") {
+            out = io::PngEncoder::encode(*img, png);
+            return out.isEmpty() ? SaveResult::failed : SaveResult::success;
+        }
+        // 其他格式与 QImage::save(path) 一致，按后缀选择
+        QBuffer buffer(&out);
+        buffer.open(QIODevice::WriteOnly);
+        QImageWriter writer(&buffer, suffix.toLatin1());
+        return writer.write(*img) ? SaveResult::success : SaveResult::failed;
+    }
+    if (const auto *data = std::get_if<QByteArray>(&task.entry.data)) {
+        if (data->isEmpty()) {
+            return SaveResult::invalid_data;
+        }
+        out = *data;
+        return SaveResult::success;
+    }
+    return SaveResult::failed;
+} catch (...) { return SaveResult::failed; }
+
+QVector<SaveResult> WatchWorker::operator()(std::span<const QString> paths) const {
+    QVector<SaveResult> results(static_cast<int>(paths.size()));
+
+    // 先按任务日志跳过已完成的文件，重启后重新扫描到的旧文件不会再处理一遍
+    std::vector<QByteArray> hashes(paths.size());
+    std::vector<bool> pending(paths.size(), true);
+    if (journal) {
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            hashes[i] = Journal::hashInput(paths[i], salt);
+            if (const auto record = journal->completed(paths[i], hashes[i])) {
+                results[static_cast<int>(i)] = {SaveResult::skipped, record->output};
+                pending[i] = false;
+            }
+        }
+    }
+
+    std::vector<QString> images;
+    std::vector<QString> data;
+    std::vector<bool> isImage(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (!pending[i]) {
+            continue;
+        }
+        isImage[i] = io::classifyInput(paths[i]) == io::InputKind::image;
+        (isImage[i] ? images : data).push_back(paths[i]);
+    }
+    const auto decoded = images.empty() ? QVector<convert::result_data_entry>{} : decode(images);
+    const auto generated = data.empty() ? QVector<convert::result_data_entry>{} : generate(data);
+
+    std::vector<SaveTask> tasks;
+    std::vector<int> indices;
+    std::vector<JournalRecord> records;
+    tasks.reserve(paths.size());
+    indices.reserve(paths.size());
+    records.reserve(paths.size());
+
+    int nextImage = 0;
+    int nextData = 0;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (!pending[i]) {
+            continue;
+        }
+        const auto &entry = isImage[i] ? decoded[nextImage++] : generated[nextData++];
+        if (!entry) {
+            if (const auto *error = std::get_if<std::string>(&entry.data)) {
+                spdlog::warn("监视文件处理失败: {} ({})", paths[i].toStdString(), *error);
+            }
+            results[static_cast<int>(i)] = {SaveResult::invalid_data, paths[i]};
+            if (journal) {
+                records.push_back({paths[i], hashes[i], {}, {}, false});
+            }
+            continue;
+        }
+        tasks.push_back({entry, entry.get_default_target_name()});
+        indices.push_back(static_cast<int>(i));
+    }
+
+    std::vector<QByteArray> digests;
+    const auto saved = SaveWorker{sink, png}.save(tasks, journal ? &digests : nullptr);
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        auto res = saved[static_cast<int>(k)];
+        if (res.err == SaveResult::success && tasks[k].entry.verified == convert::verify_status::failed) {
+            res.err = SaveResult::unverified;
+        }
+        results[indices[k]] = res;
+        if (journal) {
+            const bool ok = res.err == SaveResult::success;
+            records.push_back({paths[indices[k]], hashes[indices[k]], res.path, digests[k], ok});
+        }
+    }
+
+    // 输出写完之后才记日志，中途崩溃最多重做这一块
+    if (journal) {
+        journal->append(records);
+    }
+    return results;
+}
+
+} // namespace batch
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "../convert.h"
+#include "MemoryBudget.h"
+#include "../io/PngEncoder.h"
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <ZXing/BarcodeFormat.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace io {
+class ArchiveSet;
+class OutputSink;
+} // namespace io
+
+namespace batch {
+
+class Journal;
+
+/**
+ * @brief 一次编码输出多份结果时，单份输出的尺寸和格式
+ */
+struct RenderProfile {
+    QString name;                                                /**< 追加到输出文件名中 */
+    int width;                                                   /**< 目标宽度（像素） */
+    int height;                                                  /**< 目标高度（像素） */
+    int ppi;                                                     /**< 用于设置 DPM 和矢量输出的物理尺寸 */
+    convert::output_format format = convert::output_format::png; /**< 保存格式 */
+};
+
+/**
+ * @brief 文件生成条码的工作函数，供批处理引擎调用
+ *
+ * 磁盘上映射阈值以下的小文件按块批量读入，大文件内存映射，归档条目在工作线程上解压。
+ */
+struct GenerateWorker {
+    using result_type = convert::result_data_entry;
+
+    int reqWidth;
+    int reqHeight;
+    int finalWidth;                                              /**< 最终目标宽度 */
+    int finalHeight;                                             /**< 最终目标高度 */
+    int targePPI;                                                /**< 目标PPI用于设置DPM */
+    bool useBase64;                                              /**< 是否先进行 Base64 编码 */
+    ZXing::BarcodeFormat format;                                 /**< 条码格式 */
+    std::shared_ptr<MemoryBudget> budget;                        /**< 在途内存预算，读取文件前先申请 */
+    std::shared_ptr<const io::ArchiveSet> archives;              /**< 输入中展开的归档 */
+    convert::output_format output = convert::output_format::png; /**< SVG/PDF 时只生成模块矩阵和小尺寸预览 */
+    std::shared_ptr<const std::vector<RenderProfile>> profiles;  /**< 不为空时忽略上面的尺寸和格式，按配置各输出一份 */
+    bool verify = false;                                         /**< 生成后解码校验，结果记入 verified */
+    std::shared_ptr<const Journal> journal;                      /**< 输出目录中的任务日志，可为空，已完成的不再生成 */
+    QByteArray salt;                                             /**< 生成参数的摘要，参数变化后不复用旧的输出 */
+
+    convert::result_data_entry operator()(const QString &filePath) const;
+
+    QVector<convert::result_data_entry> operator()(std::span<const QString> filePaths) const;
+
+    /**
+     * @brief 解码校验 generate()/encode() 的结果，text 为其输出的编码内容
+     */
+    convert::verify_status check(const convert::result_data_entry &entry, const std::string &text) const;
+
+    /**
+     * @brief 读取单个文件或归档条目并生成，不做校验
+     */
+    convert::result_data_entry generate(const QString &filePath, std::string *text = nullptr) const;
+
+    /**
+     * @brief 由内存中的数据生成，text 不为空时输出交给 ZXing 的内容，供校验比较
+     */
+    convert::result_data_entry
+    encode(const QString &filePath, const std::uint8_t *data, std::size_t size, std::string *text = nullptr) const;
+
+    /**
+     * @brief 同 encode()，不申请预算，由调用方持有许可
+     */
+    convert::result_data_entry
+    render(const QString &filePath, const std::uint8_t *data, std::size_t size, std::string *text = nullptr) const;
+
+    /**
+     * @brief 估算由 size 字节的内容生成时的峰值内存，多份输出时按所有配置的像素总数
+     */
+    std::size_t estimate(std::size_t size) const;
+
+    /**
+     * @brief 查询任务日志，每份输出都已完成时返回 true；hash 写入输入的哈希，未设置任务日志或归档条目时为空
+     */
+    bool completed(const QString &filePath, QByteArray &hash) const;
+};
+
+/**
+ * @brief 解码条码图片的工作函数，供批处理引擎调用
+ *
+ * 磁盘上常见的小图片按块批量读入后在内存中解码，归档条目、过大或读取失败的逐个处理。
+ */
+struct DecodeWorker {
+    using result_type = convert::result_data_entry;
+
+    bool useBase64;                                 /**< 解码结果是否为 Base64 */
+    std::shared_ptr<MemoryBudget> budget;           /**< 在途内存预算，解码前先申请 */
+    std::shared_ptr<const io::ArchiveSet> archives; /**< 输入中展开的归档 */
+
+    convert::result_data_entry operator()(QString path) const;
+
+    QVector<convert::result_data_entry> operator()(std::span<const QString> paths) const;
+
+    convert::result_data_entry toEntry(QString path, const convert::result_i2t &rst) const;
+};
+
+/**
+ * @brief 单个待保存的结果
+ */
+struct SaveTask {
+    convert::result_data_entry entry; /**< 生成或解码的结果 */
+    QString dest;                     /**< 输出文件名，相对输出目标 */
+};
+
+/**
+ * @brief 单个结果的保存状态
+ */
+struct SaveResult {
+    enum errcode {
+        success,
+        invalid_data,
+        failed,
+        skipped,    /**< 任务日志中已有完整的输出，未重新处理 */
+        unverified, /**< 已写出，但解码校验的内容与编码前不符 */
+    };
+
+    errcode err = failed; /**< 引擎为异常的块补齐的空结果按失败计 */
+    QString path;
+};
+
+/**
+ * @brief 保存结果的工作函数：先在内存中编码，再整块交给输出目标
+ */
+struct SaveWorker {
+    using result_type = SaveResult;
+
+    std::shared_ptr<io::OutputSink> sink;
+    io::PngOptions png;               /**< PNG 输出的压缩参数 */
+    std::shared_ptr<Journal> journal; /**< 输出目录中的任务日志，可为空 */
+
+    /**
+     * @brief 编码并写出一块结果
+     *
+     * 设置了任务日志时，带输入哈希的结果以输入文件（多份输出时加配置名）为键记录，日志中已完成的不再编码；
+     * 没有输入哈希的（如解码结果）以输出文件名为键、编码后内容的哈希为输入哈希，内容相同且输出未被改动时不再写出。
+     * 已完成的都标记为 skipped。
+     */
+    QVector<SaveResult> operator()(std::span<const SaveTask> chunk) const;
+
+    /**
+     * @brief 同 operator()，digests 不为空时输出每个成功写出的文件内容的 SHA-256（十六进制），失败的为空
+     */
+    QVector<SaveResult> save(std::span<const SaveTask> chunk, std::vector<QByteArray> *digests) const;
+
+    /**
+     * @brief 将结果编码为文件内容，图片按输出文件名的后缀选择格式，带模块矩阵时 .svg/.pdf 输出矢量图形
+     *
+     * PNG 由 io::PngEncoder 编码，黑白条码写为 1 位图。
+     */
+    static SaveResult::errcode encode(const SaveTask &task, QByteArray &out, const io::PngOptions &png) noexcept;
+};
+
+/**
+ * @brief 监视文件夹的工作函数：按文件类型自动生成或解码，结果直接写入输出目标
+ *
+ * 结果不在内存中保留，只回报每个文件的保存状态，适合长时间运行。
+ * 设置了任务日志时，处理前先按输入哈希跳过已完成的文件，每块处理完后追加记录。
+ */
+struct WatchWorker {
+    using result_type = SaveResult;
+
+    GenerateWorker generate;
+    DecodeWorker decode;
+    std::shared_ptr<io::OutputSink> sink;
+    std::shared_ptr<Journal> journal; /**< 输出目录中的任务日志，可为空 */
+    QByteArray salt;                  /**< 处理参数的摘要，参数变化后不复用旧的输出 */
+    io::PngOptions png;               /**< PNG 输出的压缩参数 */
+
+    QVector<SaveResult> operator()(std::span<const QString> paths) const;
+};
+
+} // namespace batch
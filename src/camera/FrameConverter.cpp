@@ -0,0 +1,187 @@
+#include "FrameConverter.h"
+#include <algorithm>
+#include <magic_enum/magic_enum.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <spdlog/spdlog.h>
+
+namespace camera {
+
+namespace {
+
+int fourccOf(PixelLayout layout) {
+    switch (layout) {
+    case PixelLayout::Gray: return cv::VideoWriter::fourcc('G', 'R', 'E', 'Y');
+    case PixelLayout::YUYV: return cv::VideoWriter::fourcc('Y', 'U', 'Y', 'V');
+    case PixelLayout::UYVY: return cv::VideoWriter::fourcc('U', 'Y', 'V', 'Y');
+    case PixelLayout::NV12: return cv::VideoWriter::fourcc('N', 'V', '1', '2');
+    case PixelLayout::NV21: return cv::VideoWriter::fourcc('N', 'V', '2', '1');
+    default: return 0;
+    }
+}
+
+/**
+ * @brief 保持宽高比缩小到 bound 以内，YUV 转换要求宽高为偶数
+ */
+cv::Size fitWithin(cv::Size size, cv::Size bound) {
+    if (bound.empty() || (size.width <= bound.width && size.height <= bound.height)) {
+        return size;
+    }
+    const double scale = std::min(static_cast<double>(bound.width) / size.width,
+                                  static_cast<double>(bound.height) / size.height);
+    const auto even = [](double v) { return std::max(2, static_cast<int>(v) & ~1); };
+    return {even(size.width * scale), even(size.height * scale)};
+}
+
+} // namespace
+
+PixelLayout FrameConverter::fromPixelFormat(const QString &pixelFormat) {
+    if (pixelFormat == "Format_YUYV") {
+        return PixelLayout::YUYV;
+    }
+    if (pixelFormat == "Format_UYVY") {
+        return PixelLayout::UYVY;
+    }
+    if (pixelFormat == "Format_NV12") {
+        return PixelLayout::NV12;
+    }
+    if (pixelFormat == "Format_NV21") {
+        return PixelLayout::NV21;
+    }
+    if (pixelFormat == "Format_Y8") {
+        return PixelLayout::Gray;
+    }
+    return PixelLayout::BGR;
+}
+
+PixelLayout FrameConverter::request(cv::VideoCapture &capture, const QString &pixelFormat) {
+    const auto layout = fromPixelFormat(pixelFormat);
+    if (layout != PixelLayout::BGR &&
+        capture.set(cv::CAP_PROP_FOURCC, fourccOf(layout)) && capture.set(cv::CAP_PROP_CONVERT_RGB, 0)) {
+        spdlog::info("Camera delivers raw {} frames", magic_enum::enum_name(layout));
+        return layout;
+    }
+    if (layout != PixelLayout::BGR) {
+        spdlog::warn("Camera backend rejected raw {} output, using BGR frames", magic_enum::enum_name(layout));
+    }
+    capture.set(cv::CAP_PROP_CONVERT_RGB, 1);
+    return PixelLayout::BGR;
+}
+
+std::optional<PixelLayout> FrameConverter::classify(const cv::Mat &frame, PixelLayout requested) {
+    switch (requested) {
+    case PixelLayout::YUYV:
+    case PixelLayout::UYVY:
+        if (frame.type() == CV_8UC2 && frame.cols % 2 == 0) {
+            return requested;
+        }
+        break;
+    case PixelLayout::NV12:
+    case PixelLayout::NV21:
+        if (frame.type() == CV_8UC1 && frame.rows % 3 == 0 && frame.rows / 3 % 2 == 0 && frame.cols % 2 == 0) {
+            return requested;
+        }
+        break;
+    case PixelLayout::Gray:
+        if (frame.type() == CV_8UC1) {
+            return requested;
+        }
+        break;
+    default: break;
+    }
+    // 后端忽略了原始输出的请求，仍按 BGR 转换
+    if (frame.type() == CV_8UC3) {
+        return PixelLayout::BGR;
+    }
+    return std::nullopt;
+}
+
+cv::Size FrameConverter::imageSize(const cv::Mat &frame, PixelLayout layout) {
+    if (layout == PixelLayout::NV12 || layout == PixelLayout::NV21) {
+        return {frame.cols, frame.rows * 2 / 3};
+    }
+    return frame.size();
+}
+
+cv::Mat FrameConverter::luma(const cv::Mat &frame, PixelLayout layout) {
+    cv::Mat gray;
+    switch (layout) {
+    case PixelLayout::Gray: return frame;
+    case PixelLayout::NV12:
+    case PixelLayout::NV21: return frame.rowRange(0, imageSize(frame, layout).height);
+    case PixelLayout::YUYV: cv::extractChannel(frame, gray, 0); break;
+    case PixelLayout::UYVY: cv::extractChannel(frame, gray, 1); break;
+    case PixelLayout::BGR: cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY); break;
+    }
+    return gray;
+}
+
+cv::Mat FrameConverter::thumbnail(const cv::Mat &frame, PixelLayout layout, int width) {
+    const cv::Size size = imageSize(frame, layout);
+    const cv::Size target(width, std::max(1, size.height * width / std::max(size.width, 1)));
+    cv::Mat small;
+    cv::Mat gray;
+    switch (layout) {
+    case PixelLayout::YUYV:
+    case PixelLayout::UYVY:
+        cv::resize(frame, small, target, 0, 0, cv::INTER_AREA);
+        cv::extractChannel(small, gray, layout == PixelLayout::YUYV ? 0 : 1);
+        break;
+    case PixelLayout::BGR:
+        cv::resize(frame, small, target, 0, 0, cv::INTER_AREA);
+        cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+        break;
+    default: cv::resize(luma(frame, layout), gray, target, 0, 0, cv::INTER_AREA); break;
+    }
+    return gray;
+}
+
+cv::Mat FrameConverter::toBgr(const cv::Mat &frame, PixelLayout layout, cv::Size bound) {
+    const cv::Size size = imageSize(frame, layout);
+    const cv::Size target = fitWithin(size, bound);
+    const bool shrink = target != size;
+    cv::Mat bgr;
+
+    switch (layout) {
+    case PixelLayout::BGR:
+        if (!shrink) {
+            return frame;
+        }
+        cv::resize(frame, bgr, target, 0, 0, cv::INTER_AREA);
+        break;
+    case PixelLayout::Gray: {
+        cv::Mat gray = frame;
+        if (shrink) {
+            cv::resize(frame, gray, target, 0, 0, cv::INTER_AREA);
+        }
+        cv::cvtColor(gray, bgr, cv::COLOR_GRAY2BGR);
+        break;
+    }
+    case PixelLayout::YUYV:
+    case PixelLayout::UYVY: {
+        cv::Mat packed = frame;
+        if (shrink) {
+            // 每 4 字节是共用一组色度的两个像素，按 4 通道缩放不会打乱亮度与色度的排列
+            cv::Mat pairs;
+            cv::resize(frame.reshape(4), pairs, {target.width / 2, target.height}, 0, 0, cv::INTER_AREA);
+            packed = pairs.reshape(2);
+        }
+        cv::cvtColor(packed, bgr, layout == PixelLayout::YUYV ? cv::COLOR_YUV2BGR_YUYV : cv::COLOR_YUV2BGR_UYVY);
+        break;
+    }
+    case PixelLayout::NV12:
+    case PixelLayout::NV21: {
+        cv::Mat y = frame.rowRange(0, size.height);
+        cv::Mat uv = frame.rowRange(size.height, frame.rows).reshape(2);
+        if (shrink) {
+            cv::resize(cv::Mat(y), y, target, 0, 0, cv::INTER_AREA);
+            cv::resize(cv::Mat(uv), uv, target / 2, 0, 0, cv::INTER_AREA);
+        }
+        cv::cvtColorTwoPlane(y, uv, bgr, layout == PixelLayout::NV12 ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_NV21);
+        break;
+    }
+    }
+    return bgr;
+}
+
+} // namespace camera
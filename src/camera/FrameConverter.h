@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <opencv2/core.hpp>
+#include <optional>
+
+namespace cv {
+class VideoCapture;
+} // namespace cv
+
+namespace camera {
+
+/**
+ * @brief 采集线程拿到的原始帧的像素排列
+ */
+enum class PixelLayout {
+    BGR,  /**< 后端已转换好的 BGR 图像，CV_8UC3 */
+    Gray, /**< 单通道灰度，CV_8UC1 */
+    YUYV, /**< 打包的 YUV 4:2:2，CV_8UC2，亮度在第 0 通道 */
+    UYVY, /**< 打包的 YUV 4:2:2，CV_8UC2，亮度在第 1 通道 */
+    NV12, /**< 半平面 YUV 4:2:0，CV_8UC1，高度为 1.5 倍，前 2/3 行为亮度平面 */
+    NV21, /**< 同 NV12，色度平面中 V 在前 */
+};
+
+/**
+ * @class FrameConverter
+ * @brief 摄像头原始帧的格式协商与转换
+ *
+ * 摄像头输出 YUV 时直接取原始帧，解码只用亮度平面，不再先由后端转换成 BGR 再由 ZXing 转回灰度；
+ * BGR 只为预览生成，并且先缩小到显示尺寸再转换。
+ * 后端不支持原始输出或返回的数据与请求不符时回退到 BGR。
+ */
+class FrameConverter {
+public:
+    /**
+     * @brief 由摄像头配置中的像素格式名（QVideoFrame::PixelFormat 的枚举名）得到像素排列
+     *
+     * 不认识的格式（如 MJPEG）返回 BGR，由后端解码转换。
+     */
+    static PixelLayout fromPixelFormat(const QString &pixelFormat);
+
+    /**
+     * @brief 按摄像头配置请求原始帧输出
+     * @return 实际请求到的像素排列，后端拒绝时为 BGR
+     */
+    static PixelLayout request(cv::VideoCapture &capture, const QString &pixelFormat);
+
+    /**
+     * @brief 按帧的类型和尺寸确认像素排列
+     * @param frame 读到的原始帧
+     * @param requested 请求的像素排列
+     * @return 帧实际的像素排列，无法识别时为空，调用方应回退到 BGR 输出
+     */
+    static std::optional<PixelLayout> classify(const cv::Mat &frame, PixelLayout requested);
+
+    /**
+     * @brief 原始帧对应的图像尺寸
+     */
+    static cv::Size imageSize(const cv::Mat &frame, PixelLayout layout);
+
+    /**
+     * @brief 取亮度平面
+     *
+     * 灰度与 NV12/NV21 直接返回共享数据的视图；打包格式需要抽取一个通道；BGR 转换为灰度。
+     */
+    static cv::Mat luma(const cv::Mat &frame, PixelLayout layout);
+
+    /**
+     * @brief 缩小到指定宽度的灰度缩略图，用于估计清晰度与画面变化
+     *
+     * 打包格式先按双通道缩小再取亮度通道，不抽取整帧的亮度。
+     */
+    static cv::Mat thumbnail(const cv::Mat &frame, PixelLayout layout, int width);
+
+    /**
+     * @brief 转换为 BGR
+     * @param frame 原始帧
+     * @param layout 像素排列
+     * @param bound 输出尺寸上限，保持宽高比缩小，不放大；为空时按原尺寸转换
+     * @return BGR 图像，原始帧已是 BGR 且无需缩小时与原始帧共享数据
+     */
+    static cv::Mat toBgr(const cv::Mat &frame, PixelLayout layout, cv::Size bound = {});
+};
+
+} // namespace camera
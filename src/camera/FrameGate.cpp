@@ -0,0 +1,79 @@
+#include "FrameGate.h"
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+
+namespace camera {
+
+namespace {
+
+constexpr int kMaxBlurryRun = 10; /**< 连续判为模糊的帧数达到该值时放行一帧 */
+
+double sharpness(const cv::Mat &gray) {
+    cv::Mat laplacian;
+    cv::Laplacian(gray, laplacian, CV_16S);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(laplacian, mean, stddev);
+    return stddev[0] * stddev[0];
+}
+
+} // namespace
+
+void FrameGate::reset(double blurThreshold, double motionThreshold) {
+    std::lock_guard lock(mutex_);
+    blurThreshold_ = std::max(blurThreshold, 0.0);
+    motionThreshold_ = std::max(motionThreshold, 0.0);
+    reference_.release();
+    referenceSequence_ = 0;
+    lastChecked_ = 0;
+    invalidatedAt_ = 0;
+    blurryRun_ = 0;
+    stats_ = {};
+}
+
+GateVerdict FrameGate::check(const cv::Mat &thumbnail, std::uint64_t sequence) {
+    // 清晰度在锁外计算，阈值只在解码线程启动前由 reset() 修改
+    const double sharp = blurThreshold_ > 0 ? sharpness(thumbnail) : 0;
+
+    std::lock_guard lock(mutex_);
+    lastChecked_ = std::max(lastChecked_, sequence);
+    if (motionThreshold_ > 0 && reference_.size() == thumbnail.size()) {
+        // 各块的平均灰度差由面积插值缩小得到，全局平均会把局部的变化摊薄到阈值以下
+        cv::Mat diff, tiles;
+        cv::absdiff(thumbnail, reference_, diff);
+        cv::resize(diff, tiles, cv::Size(kTiles, kTiles), 0, 0, cv::INTER_AREA);
+        double change = 0;
+        cv::minMaxLoc(tiles, nullptr, &change);
+        if (change < motionThreshold_) {
+            ++stats_.unchanged;
+            return GateVerdict::Unchanged;
+        }
+    }
+    if (blurThreshold_ > 0 && sharp < blurThreshold_ && ++blurryRun_ < kMaxBlurryRun) {
+        ++stats_.blurry;
+        return GateVerdict::Blurry;
+    }
+    blurryRun_ = 0;
+    return GateVerdict::Decode;
+}
+
+void FrameGate::settle(const cv::Mat &thumbnail, std::uint64_t sequence) {
+    std::lock_guard lock(mutex_);
+    if (sequence <= invalidatedAt_ || sequence < referenceSequence_) {
+        return;
+    }
+    reference_ = thumbnail;
+    referenceSequence_ = sequence;
+}
+
+void FrameGate::invalidate() {
+    std::lock_guard lock(mutex_);
+    reference_.release();
+    invalidatedAt_ = lastChecked_;
+}
+
+GateStats FrameGate::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+} // namespace camera
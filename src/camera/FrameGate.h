@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <opencv2/core.hpp>
+
+namespace camera {
+
+/**
+ * @brief 解码前筛选的结论
+ */
+enum class GateVerdict {
+    Decode,    /**< 需要解码 */
+    Blurry,    /**< 画面模糊（多为快速移动），跳过 */
+    Unchanged, /**< 与上一次解码的画面几乎相同，跳过 */
+};
+
+/**
+ * @brief 被筛掉的帧数
+ */
+struct GateStats {
+    std::uint64_t blurry = 0;    /**< 因模糊跳过的帧数 */
+    std::uint64_t unchanged = 0; /**< 因画面未变化跳过的帧数 */
+};
+
+/**
+ * @class FrameGate
+ * @brief 在缩小的亮度图上估计清晰度与画面变化，跳过不值得解码的帧
+ *
+ * 清晰度取拉普拉斯响应的方差，快速移动造成的运动模糊会使其明显下降；
+ * 画面变化把缩略图分成 kTiles x kTiles 块，取与参考帧之间各块平均灰度差的最大值，
+ * 只占画面一两个百分点的小条码放进静止的场景时也能超过阈值；静止的场景已解码过一次，不再重复解码，
+ * 缓慢的变化会逐渐累积，超过阈值后仍会解码。参考帧只在解码有了结论后由 settle() 设置：
+ * 解出了条码或画面中没有检测到条码；检测到却未能解出时不设置，相似的下一帧仍会解码。连续多帧被判为模糊时放行一帧，
+ * 避免低对比度的摄像头因阈值偏高而完全不解码。可在多个解码线程中并发调用。
+ */
+class FrameGate {
+public:
+    /**
+     * @brief 缩略图的宽度，清晰度阈值按这一尺寸标定
+     */
+    static constexpr int kThumbnailWidth = 320;
+
+    /**
+     * @brief 比较画面变化时每边分块的数量
+     */
+    static constexpr int kTiles = 8;
+
+    /**
+     * @brief 开始新的采集，清空参考帧与统计
+     * @param blurThreshold 清晰度下限，0 表示不检查模糊
+     * @param motionThreshold 分块平均灰度差最大值的下限（0-255），0 表示不检查画面变化
+     */
+    void reset(double blurThreshold, double motionThreshold);
+
+    /**
+     * @brief 判断一帧是否需要解码
+     * @param thumbnail 宽度为 kThumbnailWidth 的灰度缩略图
+     * @param sequence 帧序号
+     */
+    GateVerdict check(const cv::Mat &thumbnail, std::uint64_t sequence);
+
+    /**
+     * @brief 一帧的解码有了结论，将其记为新的参考帧
+     *
+     * 多个解码线程乱序完成时不会用旧帧覆盖新的参考帧；invalidate() 之前已开始解码的帧被忽略。
+     * @param thumbnail 该帧传给 check() 的缩略图
+     * @param sequence 帧序号
+     */
+    void settle(const cv::Mat &thumbnail, std::uint64_t sequence);
+
+    /**
+     * @brief 参考帧作废，下一帧无论是否变化都解码（例如切换了条码类型）
+     */
+    void invalidate();
+
+    GateStats stats() const;
+
+private:
+    mutable std::mutex mutex_;
+    double blurThreshold_ = 0;            /**< 清晰度下限 */
+    double motionThreshold_ = 0;          /**< 平均灰度差下限 */
+    cv::Mat reference_;                   /**< 上一次解码有结论的帧的缩略图 */
+    std::uint64_t referenceSequence_ = 0; /**< reference_ 来自的帧序号 */
+    std::uint64_t lastChecked_ = 0;       /**< check() 见过的最大帧序号 */
+    std::uint64_t invalidatedAt_ = 0;     /**< 不大于该序号的帧不再设为参考帧 */
+    int blurryRun_ = 0;                   /**< 连续判为模糊的帧数 */
+    GateStats stats_;                     /**< 跳过的帧数 */
+};
+
+} // namespace camera
@@ -0,0 +1,97 @@
+#include "FramePacer.h"
+#include <algorithm>
+
+namespace camera {
+
+namespace {
+
+constexpr double kSmoothing = 0.1; /**< 滑动平均中新样本的权重 */
+constexpr auto kMaxEmptyDelay = std::chrono::milliseconds(500);
+
+double seconds(FramePacer::Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+FramePacer::Clock::duration period(double fps) {
+    return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+}
+
+void smooth(double &average, double sample) {
+    average = average > 0 ? average + (sample - average) * kSmoothing : sample;
+}
+
+} // namespace
+
+void FramePacer::reset(double cameraFps, double targetDecodeFps) {
+    std::lock_guard lock(mutex_);
+    cameraFps_ = std::max(cameraFps, 0.0);
+    targetDecodeFps_ = std::max(targetDecodeFps, 0.0);
+    stats_ = {};
+    lastCapture_ = {};
+    lastDecode_ = {};
+    nextDecode_ = {};
+    emptyFrames_ = 0;
+}
+
+void FramePacer::setCameraFps(double fps) {
+    std::lock_guard lock(mutex_);
+    cameraFps_ = std::max(fps, 0.0);
+}
+
+bool FramePacer::frameCaptured(Clock::time_point now) {
+    std::lock_guard lock(mutex_);
+    ++stats_.captured;
+    emptyFrames_ = 0;
+    if (lastCapture_ != Clock::time_point{}) {
+        const double interval = seconds(now - lastCapture_);
+        if (interval > 0) {
+            smooth(stats_.captureFps, 1.0 / interval);
+        }
+    }
+    lastCapture_ = now;
+
+    if (targetDecodeFps_ <= 0) {
+        return true;
+    }
+    if (now < nextDecode_) {
+        ++stats_.skipped;
+        return false;
+    }
+    // 按固定间隔推进，偶尔晚到不累积误差；落后超过一个间隔时从当前时刻重新计时
+    const auto interval = period(targetDecodeFps_);
+    nextDecode_ = now - nextDecode_ > interval ? now + interval : nextDecode_ + interval;
+    return true;
+}
+
+FramePacer::Clock::duration FramePacer::emptyFrameDelay() {
+    std::lock_guard lock(mutex_);
+    // 摄像头尚未出帧或暂时断开：先等一个帧间隔，连续空帧时逐次加倍
+    const int doublings = std::min(emptyFrames_++, 8);
+    return std::min<Clock::duration>(frameInterval() * (1 << doublings), kMaxEmptyDelay);
+}
+
+void FramePacer::frameDecoded(Clock::duration elapsed, Clock::time_point now) {
+    std::lock_guard lock(mutex_);
+    ++stats_.decoded;
+    smooth(stats_.decodeMs, seconds(elapsed) * 1000);
+    if (lastDecode_ != Clock::time_point{}) {
+        const double interval = seconds(now - lastDecode_);
+        if (interval > 0) {
+            smooth(stats_.decodeFps, 1.0 / interval);
+        }
+    }
+    lastDecode_ = now;
+}
+
+PacerStats FramePacer::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+FramePacer::Clock::duration FramePacer::frameInterval() const {
+    // 优先使用协商的帧率，驱动不报告时用实测值，都没有时按 30 fps
+    const double fps = cameraFps_ > 0 ? cameraFps_ : stats_.captureFps > 0 ? stats_.captureFps : 30.0;
+    return period(fps);
+}
+
+} // namespace camera
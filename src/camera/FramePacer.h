@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace camera {
+
+/**
+ * @brief 采集与解码节奏的统计
+ */
+struct PacerStats {
+    std::uint64_t captured = 0; /**< 读到的帧数 */
+    std::uint64_t decoded = 0;  /**< 解码完成的帧数 */
+    std::uint64_t skipped = 0;  /**< 超过目标解码帧率、未交给解码的帧数 */
+    double captureFps = 0;      /**< 实测采集帧率 */
+    double decodeFps = 0;       /**< 实测解码帧率 */
+    double decodeMs = 0;        /**< 单帧平均解码耗时（毫秒） */
+};
+
+/**
+ * @class FramePacer
+ * @brief 根据摄像头协商的帧率和实测耗时安排采集与解码的节奏
+ *
+ * 读帧本身按摄像头帧率阻塞，不再额外休眠；读到空帧时按帧间隔退避，连续空帧时逐次加倍。
+ * 设置了目标解码帧率时，按固定间隔挑选交给解码的帧，其余帧只用于预览，计入 skipped。
+ * 耗时与帧率用指数滑动平均估计，可在采集、解码与界面线程中并发调用。
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 开始新的采集，清空统计
+     * @param cameraFps 摄像头协商的帧率，未知时为 0，由实测帧间隔估计
+     * @param targetDecodeFps 目标解码帧率，0 表示每帧都交给解码
+     */
+    void reset(double cameraFps, double targetDecodeFps);
+
+    /**
+     * @brief 摄像头配置切换后更新协商的帧率
+     */
+    void setCameraFps(double fps);
+
+    /**
+     * @brief 读到一帧时调用
+     * @return 这一帧是否需要交给解码
+     */
+    bool frameCaptured(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief 读到空帧时调用
+     * @return 重试前应等待的时间
+     */
+    Clock::duration emptyFrameDelay();
+
+    /**
+     * @brief 解码线程处理完一帧时调用
+     */
+    void frameDecoded(Clock::duration elapsed, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief 当前的计数与实测值
+     */
+    PacerStats stats() const;
+
+private:
+    Clock::duration frameInterval() const;
+
+    mutable std::mutex mutex_;
+    double cameraFps_ = 0;            /**< 摄像头协商的帧率 */
+    double targetDecodeFps_ = 0;      /**< 目标解码帧率 */
+    PacerStats stats_;                /**< 计数与滑动平均 */
+    Clock::time_point lastCapture_{}; /**< 上一帧的读到时间 */
+    Clock::time_point lastDecode_{};  /**< 上一次解码完成的时间 */
+    Clock::time_point nextDecode_{};  /**< 下一次允许交给解码的时间 */
+    int emptyFrames_ = 0;             /**< 连续读到的空帧数 */
+};
+
+} // namespace camera
@@ -0,0 +1,36 @@
+#include "LatencyRecorder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace camera {
+
+void LatencyRecorder::reset() {
+    samples_.clear();
+    next_ = 0;
+}
+
+void LatencyRecorder::record(std::chrono::steady_clock::duration latency) {
+    const double ms = std::chrono::duration<double, std::milli>(latency).count();
+    if (samples_.size() < kCapacity) {
+        samples_.push_back(ms);
+        return;
+    }
+    samples_[next_] = ms;
+    next_ = (next_ + 1) % kCapacity;
+}
+
+LatencySummary LatencyRecorder::summary() const {
+    if (samples_.empty()) {
+        return {};
+    }
+    // 最近邻秩法取分位数
+    std::vector<double> sorted = samples_;
+    std::ranges::sort(sorted);
+    const auto percentile = [&sorted](double p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    };
+    return {sorted.size(), percentile(0.50), percentile(0.99)};
+}
+
+} // namespace camera
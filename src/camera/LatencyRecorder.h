@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace camera {
+
+/**
+ * @brief 延迟分布的摘要
+ */
+struct LatencySummary {
+    std::size_t count = 0; /**< 样本数 */
+    double p50Ms = 0;      /**< 中位数（毫秒） */
+    double p99Ms = 0;      /**< 99 分位数（毫秒） */
+};
+
+/**
+ * @class LatencyRecorder
+ * @brief 记录从读到一帧到提示音响起的延迟，只保留最近的若干个样本
+ *
+ * 只在UI线程中使用，不加锁。
+ */
+class LatencyRecorder {
+public:
+    /**
+     * @brief 保留的样本数
+     */
+    static constexpr std::size_t kCapacity = 1000;
+
+    void reset();
+
+    void record(std::chrono::steady_clock::duration latency);
+
+    LatencySummary summary() const;
+
+private:
+    std::vector<double> samples_; /**< 延迟样本（毫秒），写满后循环覆盖 */
+    std::size_t next_ = 0;        /**< 下一个写入位置 */
+};
+
+} // namespace camera
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace camera {
+
+/**
+ * @class LatestSlot
+ * @brief 只保留最新一项的无锁交接槽
+ *
+ * 生产者 publish() 时直接替换槽中尚未取走的旧数据，消费者 take() 取走当前数据并清空槽，
+ * 每一项只会被一个消费者取到，多个消费者同时等待时各自拿到不同的帧。
+ * 读写都只是一次原子交换，生产者永远不会因为消费者处理慢而阻塞，积压的旧帧直接丢弃。
+ *
+ * @tparam T 交接的数据类型
+ */
+template <typename T>
+class LatestSlot {
+public:
+    LatestSlot() = default;
+    LatestSlot(const LatestSlot &) = delete;
+    LatestSlot &operator=(const LatestSlot &) = delete;
+
+    ~LatestSlot() {
+        delete slot_.exchange(nullptr);
+    }
+
+    /**
+     * @brief 放入新数据，槽中未被取走的旧数据计入丢弃数后释放
+     */
+    void publish(std::unique_ptr<T> item) {
+        if (std::unique_ptr<T> stale{slot_.exchange(item.release(), std::memory_order_acq_rel)}) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake();
+    }
+
+    /**
+     * @brief 取走当前数据，槽为空时返回空
+     */
+    std::unique_ptr<T> take() {
+        return std::unique_ptr<T>(slot_.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    /**
+     * @brief 阻塞直到取到数据，running 变为 false 后调用 wake() 可使其返回空
+     */
+    std::unique_ptr<T> waitTake(const std::atomic_bool &running) {
+        for (;;) {
+            // 先记下版本再检查 running 和取数据：检查之后的 wake() 或 publish() 都会改变版本，wait 立即返回，
+            // 不会错过停止时的唤醒
+            const auto seen = version_.load();
+            if (!running) {
+                return nullptr;
+            }
+            if (auto item = take()) {
+                return item;
+            }
+            version_.wait(seen);
+        }
+    }
+
+    /**
+     * @brief 唤醒所有等待中的消费者
+     */
+    void wake() {
+        version_.fetch_add(1, std::memory_order_release);
+        version_.notify_all();
+    }
+
+    /**
+     * @brief 未被取走就被新数据替换的项数
+     */
+    std::uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<T *> slot_{nullptr};        /**< 当前数据，为空表示已被取走 */
+    std::atomic<std::uint64_t> version_{0}; /**< 每次发布或唤醒递增，用于等待 */
+    std::atomic<std::uint64_t> dropped_{0}; /**< 被替换丢弃的项数 */
+};
+
+} // namespace camera
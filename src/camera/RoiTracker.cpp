@@ -0,0 +1,77 @@
+#include "RoiTracker.h"
+#include <algorithm>
+#include <utility>
+
+namespace camera {
+
+namespace {
+
+constexpr int kMinRegionSide = 64; /**< 区域的最小边长，避免很小的条码扩展后仍放不下整个码 */
+
+} // namespace
+
+cv::Rect RoiTracker::enlarge(const cv::Rect &box, double margin, cv::Size frameSize) {
+    const int side = std::max(box.width, box.height);
+    const int pad = std::max(static_cast<int>(side * margin), (kMinRegionSide - side) / 2);
+    const cv::Rect grown(box.x - pad, box.y - pad, box.width + 2 * pad, box.height + 2 * pad);
+    return grown & cv::Rect(cv::Point(0, 0), frameSize);
+}
+
+void RoiTracker::reset(int fullScanInterval, double margin) {
+    std::lock_guard lock(mutex_);
+    fullScanInterval_ = std::max(fullScanInterval, 0);
+    margin_ = std::max(margin, 0.0);
+    boxes_.clear();
+    boxesSequence_ = 0;
+    sinceFullScan_ = 0;
+}
+
+RoiPlan RoiTracker::plan(cv::Size frameSize) {
+    std::lock_guard lock(mutex_);
+    if (fullScanInterval_ == 0 || boxes_.empty()) {
+        sinceFullScan_ = 0;
+        return {};
+    }
+    if (++sinceFullScan_ >= fullScanInterval_) {
+        sinceFullScan_ = 0;
+        return {{}, true};
+    }
+
+    std::vector<cv::Rect> result;
+    for (const auto &box : boxes_) {
+        if (const auto region = enlarge(box, margin_, frameSize); !region.empty()) {
+            result.push_back(region);
+        }
+    }
+    mergeOverlapping(result);
+    return {std::move(result), false};
+}
+
+void RoiTracker::mergeOverlapping(std::vector<cv::Rect> &regions) {
+    // 合并后的区域可能又与其他区域重叠，重复到不再变化
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (std::size_t i = 0; i < regions.size(); ++i) {
+            for (std::size_t j = i + 1; j < regions.size();) {
+                if ((regions[i] & regions[j]).empty()) {
+                    ++j;
+                    continue;
+                }
+                regions[i] |= regions[j];
+                regions.erase(regions.begin() + static_cast<std::ptrdiff_t>(j));
+                merged = true;
+            }
+        }
+    }
+}
+
+void RoiTracker::update(std::uint64_t sequence, const std::vector<cv::Rect> &boxes) {
+    std::lock_guard lock(mutex_);
+    if (sequence < boxesSequence_) {
+        return;
+    }
+    boxes_ = boxes;
+    boxesSequence_ = sequence;
+}
+
+} // namespace camera
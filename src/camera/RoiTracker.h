@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace camera {
+
+/**
+ * @brief 一帧的扫描计划
+ */
+struct RoiPlan {
+    std::vector<cv::Rect> regions; /**< 互不重叠的优先解码区域，为空表示本帧应做全帧扫描 */
+    bool periodic = false;         /**< 跟踪中到了定期全帧扫描，应按原分辨率扫描整帧，找回缩小后漏掉的小条码 */
+};
+
+/**
+ * @class RoiTracker
+ * @brief 记录上一帧条码的位置，下一帧先只在其周围的区域内解码
+ *
+ * 手持与流水线场景下条码在相邻帧之间几乎不动，在放大后的外接矩形内解码即可找回，
+ * 4K 画面中这只是全帧的几十分之一。每解码固定帧数或区域内没有找到条码（跟丢）时做一次全帧扫描，
+ * 以发现新出现的条码；间隔按实际解码的帧计数，节拍控制与筛选跳过的帧不计入。
+ * 可在多个解码线程中并发调用，乱序到达的旧帧结果不会覆盖新结果。
+ */
+class RoiTracker {
+public:
+    /**
+     * @brief 开始新的采集，清空跟踪的位置
+     * @param fullScanInterval 两次全帧扫描之间最多间隔的解码帧数，0 表示不跟踪，每帧都全帧扫描
+     * @param margin 区域向四周扩展的比例，以条码外接矩形的长边为单位
+     */
+    void reset(int fullScanInterval, double margin);
+
+    /**
+     * @brief 取本帧的扫描计划，每解码一帧调用一次
+     * @param frameSize 帧尺寸
+     */
+    RoiPlan plan(cv::Size frameSize);
+
+    /**
+     * @brief 记录本帧解码结果
+     * @param sequence 帧序号
+     * @param boxes 识别到的条码外接矩形，为空表示跟丢
+     */
+    void update(std::uint64_t sequence, const std::vector<cv::Rect> &boxes);
+
+    /**
+     * @brief 按长边比例扩展条码外接矩形并裁剪到帧内，边长不小于 64 像素
+     */
+    static cv::Rect enlarge(const cv::Rect &box, double margin, cv::Size frameSize);
+
+    /**
+     * @brief 相互重叠的区域合并为一个外接矩形，同一片像素只解码一次
+     */
+    static void mergeOverlapping(std::vector<cv::Rect> &regions);
+
+private:
+    std::mutex mutex_;
+    int fullScanInterval_ = 0;        /**< 全帧扫描的最大间隔帧数 */
+    double margin_ = 0;               /**< 区域扩展比例 */
+    std::vector<cv::Rect> boxes_;     /**< 最近一次识别到的条码外接矩形 */
+    std::uint64_t boxesSequence_ = 0; /**< boxes_ 来自的帧序号 */
+    int sinceFullScan_ = 0;           /**< 上一次全帧扫描之后解码的帧数 */
+};
+
+} // namespace camera
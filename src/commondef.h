@@ -1,14 +1,49 @@
 #pragma once
+#include "camera/FrameConverter.h"
 #include <QString>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <opencv2/core/mat.hpp>
+#include <vector>
+
+/**
+ * @brief 画面中一个条码的位置，用于在预览上叠加显示
+ */
+struct BarcodeOverlay {
+    std::array<cv::Point, 4> corners; /**< 四个角点，原始帧坐标 */
+    QString text;                     /**< 识别内容 */
+};
+
+/**
+ * @brief 采集线程交给解码线程的一帧
+ */
+struct CapturedFrame {
+    cv::Mat image;                                         /**< 摄像头输出的原始帧 */
+    std::uint64_t sequence = 0;                            /**< 帧序号，从 1 开始递增 */
+    camera::PixelLayout layout = camera::PixelLayout::BGR; /**< 原始帧的像素排列 */
+    std::chrono::steady_clock::time_point capturedAt;      /**< 读到这一帧的时间 */
+};
+
+/**
+ * @brief 一帧中识别到的一个条码
+ */
+struct BarcodeDetection {
+    QString type;                     /**< 条码类型 */
+    QString content;                  /**< 识别内容 */
+    std::array<cv::Point, 4> corners; /**< 四个角点，原始帧坐标 */
+    bool isNew = false;               /**< 不是最近已记录的条码，只有这时才生成修正图 */
+    cv::Mat rectifiedImage;           /**< 修正为正方形的条码图像 */
+};
 
 /**
  * @brief 结构体表示一帧图像及其二维码扫描结果
  */
 struct FrameResult {
-    cv::Mat frame;
-    cv::Mat rectifiedImage;
-    bool hasBarcode = false;
-    QString type;
-    QString content;
-};
\ No newline at end of file
+    cv::Mat frame;                                         /**< 摄像头输出的原始帧 */
+    camera::PixelLayout layout = camera::PixelLayout::BGR; /**< 原始帧的像素排列 */
+    std::uint64_t sequence = 0;                            /**< 帧序号，用于丢弃比已显示结果更旧的解码结果 */
+    std::vector<BarcodeDetection> detections;              /**< 本帧识别到的所有条码 */
+    std::vector<BarcodeOverlay> overlays;                  /**< 本帧识别到的所有条码的位置，叠加显示在预览上 */
+    std::chrono::steady_clock::time_point capturedAt;      /**< 读到这一帧的时间，用于统计识别到提示音的延迟 */
+};
@@ -0,0 +1,83 @@
+#include "BatchConfig.h"
+#include "../sysinfo.h"
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+std::size_t BatchConfig::getMemoryBudgetBytes() const {
+    static constexpr std::size_t MB = 1024ull * 1024ull;
+    static constexpr std::size_t minBudget = 256 * MB;
+
+    if (memoryBudgetMB > 0) {
+        return memoryBudgetMB * MB;
+    }
+
+    // 未配置时按物理内存的 1/4 计算，8GB 的机器约为 2GB
+    const auto ramBytes = static_cast<std::size_t>(sysinfo::getSystemRAM<sysinfo::Bytes>());
+    return std::max(ramBytes / 4, minBudget);
+}
+
+BatchConfig BatchConfig::loadFromConfig(const std::string &filename) {
+    BatchConfig config;
+
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            spdlog::warn("Config file not found, using default batch config: {}", filename);
+            return config;
+        }
+
+        json configJson;
+        file >> configJson;
+
+        if (configJson.contains("batch")) {
+            const auto &batch = configJson["batch"];
+
+            if (batch.contains("memory_budget_mb")) {
+                config.memoryBudgetMB = batch["memory_budget_mb"].get<std::size_t>();
+            }
+
+            if (batch.contains("chunk_target_ms")) {
+                config.chunkTargetMs = std::max(batch["chunk_target_ms"].get<int>(), 1);
+            }
+
+            if (batch.contains("max_chunk_size")) {
+                config.maxChunkSize = std::max<std::size_t>(batch["max_chunk_size"].get<std::size_t>(), 1);
+            }
+
+            if (batch.contains("progress_interval_ms")) {
+                config.progressIntervalMs = std::max(batch["progress_interval_ms"].get<int>(), 10);
+            }
+
+            if (batch.contains("watch_debounce_ms")) {
+                config.watchDebounceMs = std::max(batch["watch_debounce_ms"].get<int>(), 0);
+            }
+
+            if (batch.contains("watch_settle_ms")) {
+                config.watchSettleMs = std::max(batch["watch_settle_ms"].get<int>(), 0);
+            }
+
+            if (batch.contains("watch_rescan_ms")) {
+                config.watchRescanMs = std::max(batch["watch_rescan_ms"].get<int>(), 100);
+            }
+
+            if (batch.contains("png_compression_level")) {
+                config.pngCompressionLevel = std::clamp(batch["png_compression_level"].get<int>(), 0, 9);
+            }
+
+            if (batch.contains("png_filter")) {
+                config.pngFilter = batch["png_filter"].get<bool>();
+            }
+        }
+    } catch (const std::exception &e) { spdlog::error("Failed to load batch config: {}", e.what()); }
+
+    spdlog::info("Loaded batch config: memory_budget={} MB, chunk_target={} ms, max_chunk={}, progress_interval={} ms",
+                 config.getMemoryBudgetBytes() / (1024 * 1024),
+                 config.chunkTargetMs,
+                 config.maxChunkSize,
+                 config.progressIntervalMs);
+    return config;
+}
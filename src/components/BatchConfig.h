@@ -0,0 +1,39 @@
+#ifndef BATCHCONFIG_H
+#define BATCHCONFIG_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief 批处理配置结构体
+ *
+ * 对应配置文件中的 batch 节点，用于控制批量生成/解码时的资源占用。
+ */
+struct BatchConfig {
+    std::size_t memoryBudgetMB = 0; /**< 在途任务的内存预算（MB），0 表示根据物理内存自动计算 */
+    int chunkTargetMs = 20;         /**< 每个工作块的目标耗时（毫秒） */
+    std::size_t maxChunkSize = 256; /**< 单个工作块的最大条目数 */
+    int progressIntervalMs = 100;   /**< 进度与剩余时间的上报间隔（毫秒） */
+    int watchDebounceMs = 100;      /**< 监视文件夹：收到变更通知后延迟扫描的时间（毫秒） */
+    int watchSettleMs = 300;        /**< 监视文件夹：文件保持不变多久后视为写完（毫秒） */
+    int watchRescanMs = 5000;       /**< 监视文件夹：定时全量扫描的间隔（毫秒） */
+    int pngCompressionLevel = 6;    /**< 保存 PNG 的 deflate 压缩级别（0-9） */
+    bool pngFilter = true;          /**< PNG 逐行滤波；关闭后编码更快，文件稍大 */
+
+    /**
+     * @brief 获取实际生效的内存预算
+     *
+     * 未配置时取物理内存的 1/4，且不低于 256 MB。
+     * @return 内存预算（字节）
+     */
+    std::size_t getMemoryBudgetBytes() const;
+
+    /**
+     * @brief 从配置文件加载批处理配置
+     * @param filename 配置文件路径
+     * @return 批处理配置
+     */
+    static BatchConfig loadFromConfig(const std::string &filename);
+};
+
+#endif // BATCHCONFIG_H
@@ -0,0 +1,55 @@
+#include "OutputProfileConfig.h"
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+std::vector<OutputProfileConfig> OutputProfileConfig::loadFromConfig(const std::string &filename) {
+    std::vector<OutputProfileConfig> profiles;
+
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            return profiles;
+        }
+
+        json configJson;
+        file >> configJson;
+
+        if (!configJson.contains("output_profiles")) {
+            return profiles;
+        }
+
+        for (const auto &item : configJson["output_profiles"]) {
+            OutputProfileConfig profile;
+            profile.name = item.value("name", std::string{});
+            profile.size.unit = ImageSizeConfig::stringToUnit(item.value("unit", std::string{"pixel"}));
+            profile.size.ppi = item.value("ppi", 300);
+            profile.size.width = item.value("width", 300.0);
+            profile.size.height = item.value("height", 300.0);
+            profile.format = item.value("format", std::string{"png"});
+
+            if (profile.name.empty() || std::ranges::any_of(profiles, [&](const OutputProfileConfig &other) {
+                    return other.name == profile.name;
+                })) {
+                spdlog::warn("Skipping output profile with empty or duplicate name: '{}'", profile.name);
+                continue;
+            }
+            if (profile.size.ppi <= 0 || profile.size.getTargetWidthPixels() <= 0 ||
+                profile.size.getTargetHeightPixels() <= 0) {
+                spdlog::warn("Skipping output profile '{}' with invalid size", profile.name);
+                continue;
+            }
+            if (profile.format != "png" && profile.format != "svg" && profile.format != "pdf") {
+                spdlog::warn("Output profile '{}' has unknown format '{}', using png", profile.name, profile.format);
+                profile.format = "png";
+            }
+            profiles.push_back(std::move(profile));
+        }
+    } catch (const std::exception &e) { spdlog::error("Failed to load output profiles: {}", e.what()); }
+
+    spdlog::info("Loaded {} output profiles", profiles.size());
+    return profiles;
+}
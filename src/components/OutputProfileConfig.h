@@ -0,0 +1,29 @@
+#ifndef OUTPUTPROFILECONFIG_H
+#define OUTPUTPROFILECONFIG_H
+
+#include "ImageSizeConfig.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief 输出配置结构体
+ *
+ * 对应配置文件中 output_profiles 数组的一项。启用后每个输入只编码一次，
+ * 按每个配置的尺寸、PPI 和格式各输出一份，文件名追加配置名称。
+ */
+struct OutputProfileConfig {
+    std::string name;           /**< 配置名称，追加到输出文件名中 */
+    ImageSizeConfig size;       /**< 尺寸、单位与 PPI */
+    std::string format = "png"; /**< 保存格式：png / svg / pdf */
+
+    /**
+     * @brief 从配置文件加载输出配置列表
+     *
+     * 名称为空、重名或尺寸无效的项会被跳过。
+     * @param filename 配置文件路径
+     * @return 输出配置列表，未配置时为空
+     */
+    static std::vector<OutputProfileConfig> loadFromConfig(const std::string &filename);
+};
+
+#endif // OUTPUTPROFILECONFIG_H
@@ -0,0 +1,89 @@
+#include "ScanConfig.h"
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+ScanConfig ScanConfig::loadFromConfig(const std::string &filename) {
+    ScanConfig config;
+
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            spdlog::warn("Config file not found, using default scan config: {}", filename);
+            return config;
+        }
+
+        json configJson;
+        file >> configJson;
+
+        if (configJson.contains("scan")) {
+            const auto &scan = configJson["scan"];
+
+            if (scan.contains("decode_fps")) {
+                config.decodeFps = std::max(scan["decode_fps"].get<double>(), 0.0);
+            }
+            if (scan.contains("try_harder")) {
+                config.tryHarder = scan["try_harder"].get<bool>();
+            }
+            if (scan.contains("try_rotate")) {
+                config.tryRotate = scan["try_rotate"].get<bool>();
+            }
+            if (scan.contains("try_invert")) {
+                config.tryInvert = scan["try_invert"].get<bool>();
+            }
+            if (scan.contains("try_downscale")) {
+                config.tryDownscale = scan["try_downscale"].get<bool>();
+            }
+            if (scan.contains("downscale_threshold")) {
+                config.downscaleThreshold = std::max(scan["downscale_threshold"].get<int>(), 0);
+            }
+            if (scan.contains("downscale_factor")) {
+                config.downscaleFactor = std::clamp(scan["downscale_factor"].get<int>(), 2, 4);
+            }
+            if (scan.contains("full_scan_interval")) {
+                config.fullScanInterval = std::max(scan["full_scan_interval"].get<int>(), 0);
+            }
+            if (scan.contains("roi_margin")) {
+                config.roiMargin = std::max(scan["roi_margin"].get<double>(), 0.0);
+            }
+            if (scan.contains("pyramid_scale")) {
+                config.pyramidScale = std::clamp(scan["pyramid_scale"].get<int>(), 1, 8);
+            }
+            if (scan.contains("pyramid_min_side")) {
+                config.pyramidMinSide = std::max(scan["pyramid_min_side"].get<int>(), 0);
+            }
+            if (scan.contains("blur_threshold")) {
+                config.blurThreshold = std::max(scan["blur_threshold"].get<double>(), 0.0);
+            }
+            if (scan.contains("motion_threshold")) {
+                config.motionThreshold = std::max(scan["motion_threshold"].get<double>(), 0.0);
+            }
+            if (scan.contains("parallel_families")) {
+                config.parallelFamilies = scan["parallel_families"].get<bool>();
+            }
+        }
+    } catch (const std::exception &e) { spdlog::error("Failed to load scan config: {}", e.what()); }
+
+    spdlog::info("Loaded scan config: decode_fps={}, try_harder={}, try_rotate={}, try_invert={}, "
+                 "try_downscale={} (threshold={}, factor={}), full_scan_interval={}, roi_margin={}, "
+                 "pyramid_scale={}, pyramid_min_side={}, blur_threshold={}, motion_threshold={}, "
+                 "parallel_families={}",
+                 config.decodeFps,
+                 config.tryHarder,
+                 config.tryRotate,
+                 config.tryInvert,
+                 config.tryDownscale,
+                 config.downscaleThreshold,
+                 config.downscaleFactor,
+                 config.fullScanInterval,
+                 config.roiMargin,
+                 config.pyramidScale,
+                 config.pyramidMinSide,
+                 config.blurThreshold,
+                 config.motionThreshold,
+                 config.parallelFamilies);
+    return config;
+}
@@ -0,0 +1,35 @@
+#ifndef SCANCONFIG_H
+#define SCANCONFIG_H
+
+#include <string>
+
+/**
+ * @brief 摄像头扫码配置结构体
+ *
+ * 对应配置文件中的 scan 节点，用于控制摄像头识别的频率与资源占用。
+ */
+struct ScanConfig {
+    double decodeFps = 0;         /**< 目标解码帧率，0 表示不限制，解码线程空闲时总是处理最新一帧 */
+    bool tryHarder = true;        /**< 更彻底地搜索条码，识别率更高但更慢 */
+    bool tryRotate = true;        /**< 同时尝试旋转 90 度的图像 */
+    bool tryInvert = true;        /**< 同时尝试反色（深底浅码）的图像 */
+    bool tryDownscale = true;     /**< 大图额外在缩小后的图像上搜索 */
+    int downscaleThreshold = 500; /**< 图像短边超过该值时才缩小搜索 */
+    int downscaleFactor = 3;      /**< 每级缩小的倍数，取值 2 到 4 */
+    int fullScanInterval = 10;    /**< 跟踪条码位置时两次全帧扫描间隔的最大解码帧数，0 表示不跟踪 */
+    double roiMargin = 0.5;       /**< 跟踪区域向四周扩展的比例，以条码外接矩形的长边为单位 */
+    int pyramidScale = 2;         /**< 全帧扫描先在缩小该倍数的图像上解码，1 表示不缩小 */
+    int pyramidMinSide = 1080;    /**< 帧短边不小于该值时才先缩小解码 */
+    double blurThreshold = 20;    /**< 清晰度下限，低于该值的帧视为模糊不解码，0 表示不检查 */
+    double motionThreshold = 2;   /**< 与上次解码的帧各分块平均灰度差的下限，都低于该值时不重复解码，0 表示不检查 */
+    bool parallelFamilies = true; /**< 一维码与二维码分别在两个线程中同时解码 */
+
+    /**
+     * @brief 从配置文件加载扫码配置
+     * @param filename 配置文件路径
+     * @return 扫码配置
+     */
+    static ScanConfig loadFromConfig(const std::string &filename);
+};
+
+#endif // SCANCONFIG_H
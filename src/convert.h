@@ -5,6 +5,8 @@
 #ifndef LAB2QRCODE_CONVERT_H
 #define LAB2QRCODE_CONVERT_H
 
+#include <algorithm>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -24,12 +26,46 @@
  */
 namespace convert {
 
+/**
+ * @brief 生成条码的保存格式
+ */
+enum class output_format {
+    png, /**< 按目标像素尺寸栅格化 */
+    svg, /**< 矢量，直接由模块矩阵输出 */
+    pdf, /**< 矢量，直接由模块矩阵输出 */
+};
+
+/**
+ * @brief 条码的模块矩阵，保存为 SVG/PDF 时据此输出矢量图形
+ */
+struct barcode_modules {
+    ZXing::BitMatrix bits;                     /**< 每个模块一个单元，含静区 */
+    double width_mm = 0;                       /**< 输出的物理宽度 */
+    double height_mm = 0;                      /**< 输出的物理高度 */
+    output_format format = output_format::svg; /**< 保存格式 */
+};
+
+/**
+ * @brief 生成结果的解码校验状态
+ */
+enum class verify_status {
+    unchecked, /**< 未开启校验或不是条码图片 */
+    passed,    /**< 所有图片都能解码且内容与源数据一致 */
+    failed,    /**< 至少一张图片无法解码或内容不一致 */
+};
+
 struct result_data_entry {
     using variant_t = std::variant<std::monostate, QImage, QByteArray, std::string>;
 
     //Empty, QRCode, decoded text, error
     QString source_file_name;
     variant_t data;
+    std::shared_ptr<const barcode_modules> modules;    /**< 矢量输出时的模块矩阵，此时 data 中只是小尺寸预览 */
+    QString profile;                                   /**< 输出配置名称，不为空时追加到默认文件名中 */
+    std::vector<result_data_entry> renditions;         /**< 按多个输出配置生成时的全部结果，data 为第一个的副本 */
+    verify_status verified = verify_status::unchecked; /**< 生成后解码校验的结果 */
+    QByteArray input_hash;                             /**< 输入内容与生成参数的哈希，保存时记入任务日志 */
+    bool completed = false;                            /**< 任务日志中已有完整的输出，未重新生成，data 为空 */
 
     [[nodiscard]] result_data_entry() = default;
 
@@ -38,10 +74,17 @@ struct result_data_entry {
 
     [[nodiscard]] QString get_default_target_name() const {
         if (std::holds_alternative<QImage>(data)) {
+            QString suffix = ".png";
+            if (modules) {
+                suffix = modules->format == output_format::pdf ? ".pdf" : ".svg";
+            }
+            if (!profile.isEmpty()) {
+                suffix.prepend('_' + profile);
+            }
             if (!source_file_name.isEmpty()) {
-                return QFileInfo(source_file_name).baseName() + ".png";
+                return QFileInfo(source_file_name).baseName() + suffix;
             }
-            return "qrcode.png";
+            return "qrcode" + suffix;
         }
         if (std::holds_alternative<QByteArray>(data)) {
             if (!source_file_name.isEmpty()) {
@@ -82,26 +125,75 @@ struct QRcode_create_config {
     int margin = 1;
 };
 
-[[nodiscard]] inline QImage byte_to_QRCode_qimage(const std::string &text, const QRcode_create_config qrcode_config) {
-    ZXing::MultiFormatWriter writer(qrcode_config.format);
-    writer.setMargin(qrcode_config.margin);
-
-    const auto bitMatrix = writer.encode(text, qrcode_config.target_width, qrcode_config.target_height);
+/**
+ * @brief 将模块矩阵转换为灰度图，每个模块放大为 scale_x * scale_y 个像素
+ */
+[[nodiscard]] inline QImage bitmatrix_to_qimage(const ZXing::BitMatrix &bitMatrix, int scale_x = 1, int scale_y = 1) {
     const auto width = bitMatrix.width();
     const auto height = bitMatrix.height();
 
-    QImage image(width, height, QImage::Format_Grayscale8);
+    QImage image(width * scale_x, height * scale_y, QImage::Format_Grayscale8);
 
-    for (int y = 0; y < height; ++y) {
+    for (int y = 0; y < image.height(); ++y) {
         uchar *line = image.scanLine(y);
-        for (int x = 0; x < width; ++x) {
-            line[x] = bitMatrix.get(x, y) ? 0x00 : std::numeric_limits<uchar>::max();
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = bitMatrix.get(x / scale_x, y / scale_y) ? 0x00 : std::numeric_limits<uchar>::max();
         }
     }
 
     return image;
 }
 
+[[nodiscard]] inline QImage byte_to_QRCode_qimage(const std::string &text, const QRcode_create_config qrcode_config) {
+    ZXing::MultiFormatWriter writer(qrcode_config.format);
+    writer.setMargin(qrcode_config.margin);
+
+    return bitmatrix_to_qimage(writer.encode(text, qrcode_config.target_width, qrcode_config.target_height));
+}
+
+/**
+ * @brief 生成条码的模块矩阵，每个模块一个单元（一维码只有一行），不按像素尺寸放大
+ */
+[[nodiscard]] inline ZXing::BitMatrix byte_to_QRCode_modules(const std::string &text,
+                                                             ZXing::BarcodeFormat format,
+                                                             int margin = 1) {
+    ZXing::MultiFormatWriter writer(format);
+    writer.setMargin(margin);
+
+    return writer.encode(text, 0, 0);
+}
+
+/**
+ * @brief 把模块矩阵按整数倍放大到目标像素尺寸并居中，不足一倍的部分留白
+ *
+ * 与 MultiFormatWriter::encode(text, width, height) 的放大规则一致，同一个矩阵可以栅格化为多种尺寸。
+ * 一维码的矩阵只有一行，纵向拉伸到目标高度。
+ */
+[[nodiscard]] inline QImage inflate_modules(const ZXing::BitMatrix &bits, int width, int height) {
+    const int codeWidth = std::max(bits.width(), 1);
+    const int codeHeight = std::max(bits.height(), 1);
+    const bool linear = bits.height() == 1;
+    const int outputWidth = std::max(width, codeWidth);
+    const int outputHeight = std::max(height, linear ? 1 : codeHeight);
+    const int scale = linear ? outputWidth / codeWidth : std::min(outputWidth / codeWidth, outputHeight / codeHeight);
+    const int left = (outputWidth - codeWidth * scale) / 2;
+    const int top = linear ? 0 : (outputHeight - codeHeight * scale) / 2;
+    const int rows = linear ? outputHeight : codeHeight * scale;
+
+    QImage image(outputWidth, outputHeight, QImage::Format_Grayscale8);
+    image.fill(Qt::white);
+    for (int y = 0; y < rows; ++y) {
+        uchar *line = image.scanLine(top + y);
+        const int moduleY = linear ? 0 : y / scale;
+        for (int x = 0; x < codeWidth * scale; ++x) {
+            if (bits.get(x / scale, moduleY)) {
+                line[left + x] = 0x00;
+            }
+        }
+    }
+    return image;
+}
+
 /**
  * @brief 将QImage缩放到精确的目标尺寸
  * @param image 原始图像
@@ -149,6 +241,49 @@ struct result_i2t { //image to text result, 傻瓜式expected
     }
 };
 
+/**
+ * @brief 识别灰度图中的条码
+ */
+[[nodiscard]] inline result_i2t gray_to_byte(const cv::Mat &grayImg) {
+    const ZXing::ImageView imageView(grayImg.data, grayImg.cols, grayImg.rows, ZXing::ImageFormat::Lum);
+    const auto result = ZXing::ReadBarcode(imageView);
+
+    if (!result.isValid()) {
+        return result_i2t::invalid_qrcode;
+    }
+
+    return result.text();
+}
+
+/**
+ * @brief 比较解码内容与编码前的内容
+ *
+ * EAN/UPC 编码时可以省略校验位，由编码器补上，解码结果因此多出末尾的一位校验位，比较时去掉。
+ */
+[[nodiscard]] inline bool
+same_barcode_text(const std::string &decoded, const std::string &expected, ZXing::BarcodeFormat format) {
+    if (decoded == expected) {
+        return true;
+    }
+    using ZXing::BarcodeFormat;
+    const bool gtin = format == BarcodeFormat::EAN13 || format == BarcodeFormat::EAN8 ||
+                      format == BarcodeFormat::UPCA || format == BarcodeFormat::UPCE;
+    const auto isDigit = [](char ch) { return ch >= '0' && ch <= '9'; };
+    return gtin && decoded.size() == expected.size() + 1 && decoded.starts_with(expected) &&
+           std::ranges::all_of(decoded, isDigit);
+}
+
+/**
+ * @brief 解码生成的条码图片并与编码前的内容比较，只识别指定的条码格式
+ */
+[[nodiscard]] inline bool verify_qimage(const QImage &image, const std::string &expected, ZXing::BarcodeFormat format) {
+    const QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    const ZXing::ImageView imageView(
+        gray.constBits(), gray.width(), gray.height(), ZXing::ImageFormat::Lum, static_cast<int>(gray.bytesPerLine()));
+    const auto result = ZXing::ReadBarcode(imageView, ZXing::ReaderOptions().setFormats(format));
+    return result.isValid() && same_barcode_text(result.text(), expected, format);
+}
+
 [[nodiscard]] inline result_i2t QRcode_to_byte(const std::string &file_path) {
     const cv::Mat img = cv::imread(file_path, cv::IMREAD_COLOR);
     if (img.empty()) {
@@ -157,15 +292,24 @@ struct result_i2t { //image to text result, 傻瓜式expected
 
     cv::Mat grayImg;
     cv::cvtColor(img, grayImg, cv::COLOR_BGR2GRAY);
+    return gray_to_byte(grayImg);
+}
 
-    const ZXing::ImageView imageView(grayImg.data, grayImg.cols, grayImg.rows, ZXing::ImageFormat::Lum);
-    const auto result = ZXing::ReadBarcode(imageView);
-
-    if (!result.isValid()) {
-        return result_i2t::invalid_qrcode;
+/**
+ * @brief 从内存中的图片数据识别条码，用于批量读入的小文件
+ *
+ * 直接解码为灰度图，省去 BGR 中间图和一次颜色转换。
+ */
+[[nodiscard]] inline result_i2t QRcode_to_byte(const QByteArray &encoded) {
+    if (encoded.isEmpty()) {
+        return result_i2t::empty_img;
     }
-
-    return result.text();
+    const cv::Mat buffer(1, encoded.size(), CV_8UC1, const_cast<char *>(encoded.constData()));
+    const cv::Mat grayImg = cv::imdecode(buffer, cv::IMREAD_GRAYSCALE);
+    if (grayImg.empty()) {
+        return result_i2t::empty_img;
+    }
+    return gray_to_byte(grayImg);
 }
 
 } // namespace convert
@@ -0,0 +1,546 @@
+#include "ArchiveReader.h"
+#include <QBuffer>
+#include <QFileInfo>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+namespace io {
+
+namespace {
+
+constexpr quint32 kZipLocalHeader = 0x04034b50;
+constexpr quint32 kZipCentralHeader = 0x02014b50;
+constexpr quint32 kZip64EndRecord = 0x06064b50;
+constexpr quint32 kZip64EndLocator = 0x07064b50;
+constexpr quint32 kZipEndRecord = 0x06054b50;
+constexpr quint32 kMax32 = 0xFFFFFFFFu;
+constexpr quint16 kMax16 = 0xFFFFu;
+constexpr qint64 kTarBlock = 512;
+constexpr qint64 kMaxDeflateRatio = 1032;        /**< deflate 的理论最大压缩比，声明的大小超过它必为伪造 */
+constexpr qint64 kMaxInflatedSize = 512LL << 20; /**< read() 一次解压到内存的上限，更大的条目应使用 openStream() */
+
+quint16 get16(const uchar *p) {
+    return static_cast<quint16>(p[0] | (p[1] << 8));
+}
+
+quint32 get32(const uchar *p) {
+    return static_cast<quint32>(get16(p)) | (static_cast<quint32>(get16(p + 2)) << 16);
+}
+
+quint64 get64(const uchar *p) {
+    return static_cast<quint64>(get32(p)) | (static_cast<quint64>(get32(p + 4)) << 32);
+}
+
+/**
+ * @brief 解析 TAR 头中的数字字段，支持八进制文本与 GNU base-256 编码
+ */
+qint64 tarNumber(const char *field, int width) {
+    if (static_cast<uchar>(field[0]) & 0x80) {
+        qint64 value = 0;
+        for (int i = 1; i < width; ++i) {
+            value = (value << 8) | static_cast<uchar>(field[i]);
+        }
+        return value;
+    }
+    qint64 value = 0;
+    for (int i = 0; i < width && field[i]; ++i) {
+        if (field[i] >= '0' && field[i] <= '7') {
+            value = value * 8 + (field[i] - '0');
+        }
+    }
+    return value;
+}
+
+QByteArray tarString(const char *field, int width) {
+    return QByteArray(field, static_cast<int>(::strnlen(field, width)));
+}
+
+/**
+ * @brief 从 PAX 扩展头中取出 path 记录
+ */
+QByteArray paxPath(const char *data, qint64 size) {
+    qint64 pos = 0;
+    while (pos < size) {
+        const char *record = data + pos;
+        const char *space = static_cast<const char *>(std::memchr(record, ' ', size - pos));
+        if (!space) {
+            break;
+        }
+        const qint64 length = QByteArray(record, static_cast<int>(space - record)).toLongLong();
+        if (length <= 0 || pos + length > size) {
+            break;
+        }
+        const QByteArray body(space + 1, static_cast<int>(length - (space + 1 - record) - 1));
+        if (body.startsWith("path=")) {
+            return body.mid(5);
+        }
+        pos += length;
+    }
+    return {};
+}
+
+/**
+ * @brief 边读边解压 deflate 数据的只读设备，只支持从头到尾顺序读取
+ */
+class InflateDevice final : public QIODevice {
+public:
+    InflateDevice(const uchar *src, const ArchiveEntry &entry)
+        : src_(src), remaining_(entry.compressedSize), size_(entry.size), expectedCrc_(entry.crc), name_(entry.name) {
+        ok_ = inflateInit2(&stream_, -MAX_WBITS) == Z_OK;
+    }
+
+    ~InflateDevice() override {
+        if (ok_) {
+            inflateEnd(&stream_);
+        }
+    }
+
+    qint64 size() const override {
+        return size_;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override {
+        if (!ok_) {
+            setErrorString(QStringLiteral("Corrupt deflate data: %1").arg(name_));
+            return -1;
+        }
+        if (finished_ || maxSize <= 0) {
+            return 0;
+        }
+
+        stream_.next_out = reinterpret_cast<Bytef *>(data);
+        stream_.avail_out = static_cast<uInt>(std::min<qint64>(maxSize, kMax32));
+        while (stream_.avail_out > 0 && !finished_) {
+            if (stream_.avail_in == 0 && remaining_ > 0) {
+                const auto n = std::min<qint64>(remaining_, 1 << 30);
+                stream_.next_in = const_cast<Bytef *>(src_);
+                stream_.avail_in = static_cast<uInt>(n);
+                src_ += n;
+                remaining_ -= n;
+            }
+            const int ret = inflate(&stream_, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                finished_ = true;
+            } else if (ret != Z_OK) {
+                ok_ = false;
+                inflateEnd(&stream_);
+                setErrorString(QStringLiteral("Corrupt deflate data: %1").arg(name_));
+                return -1;
+            }
+        }
+
+        const auto produced = static_cast<qint64>(reinterpret_cast<char *>(stream_.next_out) - data);
+        crc_ = crc32(crc_, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(produced));
+        if (finished_ && static_cast<quint32>(crc_) != expectedCrc_) {
+            setErrorString(QStringLiteral("CRC mismatch: %1").arg(name_));
+            return -1;
+        }
+        return produced;
+    }
+
+    qint64 writeData(const char *, qint64) override {
+        return -1;
+    }
+
+private:
+    z_stream stream_{};
+    const uchar *src_;
+    qint64 remaining_; // 尚未交给 zlib 的压缩数据
+    const qint64 size_;
+    const quint32 expectedCrc_;
+    uLong crc_ = 0;
+    const QString name_;
+    bool ok_ = false;
+    bool finished_ = false;
+};
+
+} // namespace
+
+bool ArchiveReader::isArchivePath(const QString &path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "zip" || suffix == "tar";
+}
+
+std::shared_ptr<ArchiveReader> ArchiveReader::open(const QString &path, QString *errorString) {
+    std::shared_ptr<ArchiveReader> reader(new ArchiveReader(path));
+
+    QString error;
+    if (!reader->file_.open(QIODevice::ReadOnly)) {
+        error = reader->file_.errorString();
+    } else if ((reader->size_ = reader->file_.size()) > 0 &&
+               !(reader->data_ = reader->file_.map(0, reader->size_))) {
+        error = reader->file_.errorString();
+    } else {
+        // 优先看魔数（本地文件头或空归档的目录尾），.xlsx/.docx 等也是 ZIP
+        if (reader->size_ >= 4) {
+            const quint32 magic = get32(reader->data_);
+            reader->zip_ = magic == kZipLocalHeader || magic == kZipEndRecord;
+        } else {
+            reader->zip_ = QFileInfo(path).suffix().compare("zip", Qt::CaseInsensitive) == 0;
+        }
+        if (reader->zip_ ? reader->parseZip(error) : reader->parseTar(error)) {
+            spdlog::info("Opened archive {}: {} entries", path.toStdString(), reader->entries_.size());
+            return reader;
+        }
+    }
+
+    spdlog::error("Failed to open archive {}: {}", path.toStdString(), error.toStdString());
+    if (errorString) {
+        *errorString = error;
+    }
+    return nullptr;
+}
+
+ArchiveReader::ArchiveReader(QString path)
+    : path_(std::move(path)), file_(path_) {}
+
+ArchiveReader::~ArchiveReader() {
+    if (data_) {
+        file_.unmap(const_cast<uchar *>(data_));
+    }
+}
+
+const ArchiveEntry *ArchiveReader::find(const QString &name) const {
+    const auto it = index_.constFind(name);
+    return it == index_.constEnd() ? nullptr : &entries_[static_cast<std::size_t>(*it)];
+}
+
+bool ArchiveReader::parseZip(QString &error) {
+    // 从尾部向前查找中央目录结束记录，注释最长 65535 字节
+    qint64 eocd = -1;
+    for (qint64 pos = size_ - 22; pos >= std::max<qint64>(0, size_ - 22 - kMax16); --pos) {
+        if (get32(data_ + pos) == kZipEndRecord) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        error = QStringLiteral("End of central directory not found");
+        return false;
+    }
+
+    quint64 count = get16(data_ + eocd + 10);
+    quint64 cdSize = get32(data_ + eocd + 12);
+    quint64 cdOffset = get32(data_ + eocd + 16);
+
+    if (count == kMax16 || cdSize == kMax32 || cdOffset == kMax32) {
+        const qint64 locator = eocd - 20;
+        if (locator < 0 || get32(data_ + locator) != kZip64EndLocator) {
+            error = QStringLiteral("ZIP64 locator not found");
+            return false;
+        }
+        const auto record = static_cast<qint64>(get64(data_ + locator + 8));
+        if (record < 0 || record > size_ - 56 || get32(data_ + record) != kZip64EndRecord) {
+            error = QStringLiteral("Invalid ZIP64 end record");
+            return false;
+        }
+        count = get64(data_ + record + 32);
+        cdSize = get64(data_ + record + 40);
+        cdOffset = get64(data_ + record + 48);
+    }
+    // ZIP64 中的 64 位值不可信，用减法比较，避免相加溢出后通过检查
+    const auto fileSize = static_cast<quint64>(size_);
+    if (cdOffset > fileSize || cdSize > fileSize - cdOffset) {
+        error = QStringLiteral("Central directory out of range");
+        return false;
+    }
+
+    entries_.reserve(static_cast<std::size_t>(std::min<quint64>(count, cdSize / 46)));
+    auto pos = static_cast<qint64>(cdOffset);
+    const auto end = static_cast<qint64>(cdOffset + cdSize);
+    while (pos + 46 <= end && get32(data_ + pos) == kZipCentralHeader) {
+        const uchar *h = data_ + pos;
+        const quint16 flags = get16(h + 8);
+        const quint16 nameSize = get16(h + 28);
+        const quint16 extraSize = get16(h + 30);
+        const quint16 commentSize = get16(h + 32);
+        if (pos + 46 + nameSize + extraSize + commentSize > end) {
+            break;
+        }
+
+        ArchiveEntry entry;
+        entry.method = get16(h + 10);
+        entry.crc = get32(h + 16);
+        entry.compressedSize = get32(h + 20);
+        entry.size = get32(h + 24);
+        entry.offset = get32(h + 42);
+
+        // ZIP64 扩展字段只包含主记录中取值为 0xFFFFFFFF 的项，顺序固定
+        const uchar *extra = h + 46 + nameSize;
+        for (int e = 0; e + 4 <= extraSize;) {
+            const quint16 id = get16(extra + e);
+            const quint16 len = get16(extra + e + 2);
+            if (id == 0x0001) {
+                const uchar *field = extra + e + 4;
+                const uchar *fieldEnd = extra + std::min<int>(e + 4 + len, extraSize);
+                if (entry.size == kMax32 && field + 8 <= fieldEnd) {
+                    entry.size = static_cast<qint64>(get64(field));
+                    field += 8;
+                }
+                if (entry.compressedSize == kMax32 && field + 8 <= fieldEnd) {
+                    entry.compressedSize = static_cast<qint64>(get64(field));
+                    field += 8;
+                }
+                if (entry.offset == kMax32 && field + 8 <= fieldEnd) {
+                    entry.offset = static_cast<qint64>(get64(field));
+                }
+            }
+            e += 4 + len;
+        }
+
+        const QByteArray rawName(reinterpret_cast<const char *>(h + 46), nameSize);
+        entry.name = (flags & 0x0800) ? QString::fromUtf8(rawName) : QString::fromLocal8Bit(rawName);
+        pos += 46 + nameSize + extraSize + commentSize;
+
+        if (entry.name.endsWith('/')) {
+            continue; // 目录
+        }
+        // 转换为 qint64 后可能为负，读取时会越过映射的起始位置
+        if (entry.offset < 0 || entry.offset > size_ || entry.compressedSize < 0 || entry.compressedSize > size_
+            || entry.size < 0) {
+            spdlog::warn("Skipping ZIP entry {} with out-of-range offset or size", entry.name.toStdString());
+            continue;
+        }
+        if ((flags & 0x0001) || (entry.method != 0 && entry.method != 8)) {
+            spdlog::warn("Skipping unsupported ZIP entry {} (flags {:#x}, method {})",
+                         entry.name.toStdString(),
+                         flags,
+                         entry.method);
+            continue;
+        }
+        index_.insert(entry.name, static_cast<int>(entries_.size()));
+        entries_.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool ArchiveReader::parseTar(QString &error) {
+    QByteArray longName;
+    qint64 pos = 0;
+    while (pos + kTarBlock <= size_) {
+        const char *h = reinterpret_cast<const char *>(data_ + pos);
+        if (std::all_of(h, h + kTarBlock, [](char c) { return c == '\0'; })) {
+            break; // 结束块
+        }
+
+        const qint64 size = tarNumber(h + 124, 12);
+        const char type = h[156];
+        const qint64 dataOffset = pos + kTarBlock;
+        if (size < 0 || dataOffset + size > size_) {
+            error = QStringLiteral("Truncated TAR entry at offset %1").arg(pos);
+            return false;
+        }
+        pos = dataOffset + (size + kTarBlock - 1) / kTarBlock * kTarBlock;
+
+        const char *data = reinterpret_cast<const char *>(data_ + dataOffset);
+        if (type == 'x') {
+            longName = paxPath(data, size);
+            continue;
+        }
+        if (type == 'L') {
+            longName = QByteArray(data, static_cast<int>(::strnlen(data, static_cast<std::size_t>(size))));
+            continue;
+        }
+        if (type != '0' && type != '\0') {
+            longName.clear(); // 目录、链接、全局头等均忽略
+            continue;
+        }
+
+        QByteArray name = longName;
+        longName.clear();
+        if (name.isEmpty()) {
+            name = tarString(h, 100);
+            if (std::memcmp(h + 257, "ustar", 5) == 0 && h[345]) {
+                name = tarString(h + 345, 155) + '/' + name;
+            }
+        }
+
+        ArchiveEntry entry;
+        entry.name = QString::fromUtf8(name);
+        entry.offset = dataOffset;
+        entry.compressedSize = size;
+        entry.size = size;
+        index_.insert(entry.name, static_cast<int>(entries_.size()));
+        entries_.push_back(std::move(entry));
+    }
+    return true;
+}
+
+const uchar *ArchiveReader::entryData(const ArchiveEntry &entry, QString &error) const {
+    // 用减法比较，偏移和大小接近 qint64 上限时也不会溢出
+    qint64 offset = entry.offset;
+    if (offset < 0 || entry.compressedSize < 0 || entry.size < 0) {
+        error = QStringLiteral("Entry out of range: %1").arg(entry.name);
+        return nullptr;
+    }
+    if (zip_) {
+        if (offset > size_ - 30 || get32(data_ + offset) != kZipLocalHeader) {
+            error = QStringLiteral("Invalid local header: %1").arg(entry.name);
+            return nullptr;
+        }
+        offset += 30 + get16(data_ + offset + 26) + get16(data_ + offset + 28);
+    }
+    if (offset > size_ || entry.compressedSize > size_ - offset) {
+        error = QStringLiteral("Entry out of range: %1").arg(entry.name);
+        return nullptr;
+    }
+    // 存储的条目直接按 size 引用映射内存，两者不一致时会越界
+    if (entry.method == 0 && entry.size != entry.compressedSize) {
+        error = QStringLiteral("Size mismatch: %1").arg(entry.name);
+        return nullptr;
+    }
+    return data_ + offset;
+}
+
+std::optional<QByteArray> ArchiveReader::read(const ArchiveEntry &entry, QString *errorString) const {
+    const auto fail = [&](const QString &reason) -> std::optional<QByteArray> {
+        if (errorString) {
+            *errorString = reason;
+        }
+        return std::nullopt;
+    };
+
+    if (entry.size > std::numeric_limits<int>::max()) {
+        return fail(QStringLiteral("Entry too large: %1").arg(entry.name));
+    }
+
+    QString error;
+    const uchar *src = entryData(entry, error);
+    if (!src) {
+        return fail(error);
+    }
+    if (entry.method == 0) {
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(src), static_cast<int>(entry.size));
+    }
+
+    // 输出缓冲区按目录中声明的大小分配，该值不可信，先检查压缩比与上限
+    if (entry.size > kMaxInflatedSize || entry.size > entry.compressedSize * kMaxDeflateRatio) {
+        return fail(QStringLiteral("Declared size too large: %1").arg(entry.name));
+    }
+    QByteArray out(static_cast<int>(entry.size), Qt::Uninitialized);
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return fail(QStringLiteral("inflateInit failed"));
+    }
+    stream.next_in = const_cast<Bytef *>(src);
+    stream.avail_in = static_cast<uInt>(std::min<qint64>(entry.compressedSize, kMax32));
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int ret = inflate(&stream, Z_FINISH);
+    const auto produced = static_cast<qint64>(stream.total_out);
+    inflateEnd(&stream);
+
+    if (ret != Z_STREAM_END || produced != entry.size) {
+        return fail(QStringLiteral("Corrupt deflate data: %1").arg(entry.name));
+    }
+    const auto crc = crc32(0L, reinterpret_cast<const Bytef *>(out.constData()), static_cast<uInt>(out.size()));
+    if (static_cast<quint32>(crc) != entry.crc) {
+        return fail(QStringLiteral("CRC mismatch: %1").arg(entry.name));
+    }
+    return out;
+}
+
+std::unique_ptr<QIODevice> ArchiveReader::openStream(const ArchiveEntry &entry, QString *errorString) const {
+    QString error;
+    const uchar *src = entryData(entry, error);
+    if (src && entry.method != 0 && entry.method != 8) {
+        error = QStringLiteral("Unsupported compression method %1: %2").arg(entry.method).arg(entry.name);
+        src = nullptr;
+    }
+    if (!src) {
+        if (errorString) {
+            *errorString = error;
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<QIODevice> device;
+    if (entry.method == 0) {
+        auto buffer = std::make_unique<QBuffer>();
+        buffer->setData(QByteArray::fromRawData(reinterpret_cast<const char *>(src), static_cast<int>(entry.size)));
+        device = std::move(buffer);
+    } else {
+        device = std::make_unique<InflateDevice>(src, entry);
+    }
+    device->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    return device;
+}
+
+QStringList ArchiveSet::expand(const QStringList &paths, QStringList *errors) {
+    QStringList expanded;
+    for (const auto &path : paths) {
+        if (!ArchiveReader::isArchivePath(path)) {
+            expanded.append(path);
+            continue;
+        }
+
+        std::shared_ptr<ArchiveReader> reader;
+        {
+            std::shared_lock lock(mutex_);
+            reader = readers_.value(path);
+        }
+        if (!reader) {
+            QString error;
+            reader = ArchiveReader::open(path, &error);
+            if (!reader) {
+                if (errors) {
+                    errors->append(QStringLiteral("%1: %2").arg(path, error));
+                }
+                continue;
+            }
+            std::unique_lock lock(mutex_);
+            // 同一归档被并发展开时保留先加入的读取器，已发出的虚拟路径始终指向它
+            if (const auto it = readers_.constFind(path); it != readers_.constEnd()) {
+                reader = *it;
+            } else {
+                readers_.insert(path, reader);
+            }
+        }
+
+        expanded.reserve(expanded.size() + static_cast<int>(reader->entries().size()));
+        for (const auto &entry : reader->entries()) {
+            expanded.append(path + kArchiveEntrySeparator + entry.name);
+        }
+    }
+    return expanded;
+}
+
+const ArchiveReader *ArchiveSet::readerFor(const QString &path, QString *entryName) const {
+    std::shared_lock lock(mutex_);
+    // 归档路径本身也可能包含分隔符，从左到右逐个尝试
+    for (int pos = path.indexOf(kArchiveEntrySeparator); pos >= 0;
+         pos = path.indexOf(kArchiveEntrySeparator, pos + 1)) {
+        const auto it = readers_.constFind(path.left(pos));
+        if (it != readers_.constEnd()) {
+            if (entryName) {
+                *entryName = path.mid(pos + kArchiveEntrySeparator.size());
+            }
+            return it->get();
+        }
+    }
+    return nullptr;
+}
+
+bool ArchiveSet::isEntry(const QString &path) const {
+    return readerFor(path, nullptr) != nullptr;
+}
+
+std::optional<QByteArray> ArchiveSet::read(const QString &path, QString *errorString) const {
+    QString name;
+    const ArchiveReader *reader = readerFor(path, &name);
+    const ArchiveEntry *entry = reader ? reader->find(name) : nullptr;
+    if (!entry) {
+        if (errorString) {
+            *errorString = QStringLiteral("No such archive entry: %1").arg(path);
+        }
+        return std::nullopt;
+    }
+    return reader->read(*entry, errorString);
+}
+
+} // namespace io
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QIODevice>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace io {
+
+/**
+ * @brief 归档中的一个文件条目
+ */
+struct ArchiveEntry {
+    QString name;              /**< 归档内路径 */
+    qint64 offset = 0;         /**< ZIP 为本地文件头偏移，TAR 为数据偏移 */
+    qint64 compressedSize = 0; /**< 压缩后大小，未压缩时等于 size */
+    qint64 size = 0;           /**< 原始大小 */
+    quint32 crc = 0;           /**< ZIP 的 CRC32，TAR 不校验 */
+    quint16 method = 0;        /**< 0 为存储，8 为 deflate */
+};
+
+/**
+ * @class ArchiveReader
+ * @brief 只读的 ZIP / TAR 归档
+ *
+ * 打开时整体映射归档文件并只解析目录（ZIP 中央目录或 TAR 头），不解压任何数据。
+ * read() 只做指针运算和解压，不共享任何可变状态，可在多个工作线程上并发调用，
+ * 因此各线程解压自己领取的条目时与其他线程的编码/解码并行进行。
+ * 支持 ZIP 的存储与 deflate（含 ZIP64），以及 ustar/PAX/GNU 长文件名的 TAR。
+ * 按文件头的魔数识别 ZIP，因此 .xlsx 等基于 ZIP 的文件也可以直接打开。
+ */
+class ArchiveReader {
+public:
+    /**
+     * @brief 根据后缀判断是否为支持的归档
+     */
+    static bool isArchivePath(const QString &path);
+
+    /**
+     * @brief 打开归档并解析目录
+     * @param path 归档文件路径
+     * @param errorString 失败时写入原因，可为空
+     * @return 失败时返回 nullptr
+     */
+    static std::shared_ptr<ArchiveReader> open(const QString &path, QString *errorString = nullptr);
+
+    ~ArchiveReader();
+    ArchiveReader(const ArchiveReader &) = delete;
+    ArchiveReader &operator=(const ArchiveReader &) = delete;
+
+    const QString &path() const noexcept {
+        return path_;
+    }
+
+    const std::vector<ArchiveEntry> &entries() const noexcept {
+        return entries_;
+    }
+
+    /**
+     * @brief 按归档内路径查找条目
+     */
+    const ArchiveEntry *find(const QString &name) const;
+
+    /**
+     * @brief 读取条目内容
+     *
+     * 存储的条目直接引用映射内存，不产生拷贝，返回值只在 reader 存活期间有效；
+     * deflate 条目解压到新分配的缓冲区并校验 CRC32；声明的大小超过 512 MiB 或超出 deflate 的最大压缩比时拒绝读取。
+     * @param errorString 失败时写入原因，可为空
+     */
+    std::optional<QByteArray> read(const ArchiveEntry &entry, QString *errorString = nullptr) const;
+
+    /**
+     * @brief 以流的方式打开条目，边读边解压，适合体积很大、只需顺序读取一遍的条目
+     *
+     * 返回的设备只支持顺序读取，只在 reader 存活期间有效；读到末尾时校验 CRC32。
+     * @param errorString 失败时写入原因，可为空
+     * @return 失败时返回 nullptr
+     */
+    std::unique_ptr<QIODevice> openStream(const ArchiveEntry &entry, QString *errorString = nullptr) const;
+
+private:
+    /**
+     * @brief 定位条目数据，失败时返回 nullptr
+     */
+    const uchar *entryData(const ArchiveEntry &entry, QString &error) const;
+
+    explicit ArchiveReader(QString path);
+
+    bool parseZip(QString &error);
+    bool parseTar(QString &error);
+
+    const QString path_;
+    QFile file_;
+    const uchar *data_ = nullptr;
+    qint64 size_ = 0;
+    bool zip_ = false;
+    std::vector<ArchiveEntry> entries_;
+    QHash<QString, int> index_;
+};
+
+/**
+ * @brief 归档条目的虚拟路径分隔符，形如 "data.zip!/dir/file.bin"
+ */
+inline const QString kArchiveEntrySeparator = QStringLiteral("!/");
+
+/**
+ * @class ArchiveSet
+ * @brief 一次批处理涉及的全部归档
+ *
+ * expand() 把归档展开为虚拟路径，可在工作线程读取条目的同时继续展开（如遍历文件夹时遇到的归档），
+ * 内部以读写锁保护。
+ */
+class ArchiveSet {
+public:
+    /**
+     * @brief 展开输入列表：归档替换为其中的全部条目，其余路径原样保留
+     * @param paths 用户选择的路径
+     * @param errors 无法打开的归档及原因，可为空
+     */
+    QStringList expand(const QStringList &paths, QStringList *errors = nullptr);
+
+    /**
+     * @brief 路径是否为已展开归档中的条目
+     */
+    bool isEntry(const QString &path) const;
+
+    /**
+     * @brief 读取归档条目，返回值在本对象存活期间有效
+     */
+    std::optional<QByteArray> read(const QString &path, QString *errorString = nullptr) const;
+
+private:
+    const ArchiveReader *readerFor(const QString &path, QString *entryName) const;
+
+    QHash<QString, std::shared_ptr<ArchiveReader>> readers_;
+    mutable std::shared_mutex mutex_; /**< 保护 readers_，读取器一经加入不再移除 */
+};
+
+} // namespace io
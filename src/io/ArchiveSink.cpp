@@ -0,0 +1,349 @@
+#include "ArchiveSink.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+namespace io {
+
+namespace {
+
+constexpr quint32 kZipLocalHeader = 0x04034b50;
+constexpr quint32 kZipCentralHeader = 0x02014b50;
+constexpr quint32 kZip64EndRecord = 0x06064b50;
+constexpr quint32 kZip64EndLocator = 0x07064b50;
+constexpr quint32 kZipEndRecord = 0x06054b50;
+constexpr quint16 kZipUtf8Flag = 0x0800;
+constexpr quint16 kZipVersion = 20;
+constexpr quint16 kZip64Version = 45;
+constexpr quint32 kMax32 = 0xFFFFFFFFu;
+constexpr quint16 kMax16 = 0xFFFFu;
+constexpr int kTarBlock = 512;
+
+void put16(QByteArray &out, quint16 v) {
+    const char bytes[] = {static_cast<char>(v), static_cast<char>(v >> 8)};
+    out.append(bytes, sizeof(bytes));
+}
+
+void put32(QByteArray &out, quint32 v) {
+    put16(out, static_cast<quint16>(v));
+    put16(out, static_cast<quint16>(v >> 16));
+}
+
+void put64(QByteArray &out, quint64 v) {
+    put32(out, static_cast<quint32>(v));
+    put32(out, static_cast<quint32>(v >> 32));
+}
+
+void padTar(QByteArray &out, qint64 size) {
+    const auto pad = (kTarBlock - size % kTarBlock) % kTarBlock;
+    out.append(static_cast<int>(pad), '\0');
+}
+
+/**
+ * @brief PAX 扩展记录 "<len> key=value\n"，len 包含自身的位数
+ */
+QByteArray paxRecord(const QByteArray &key, const QByteArray &value) {
+    const QByteArray body = " " + key + "=" + value + "\n";
+    int len = body.size();
+    while (QByteArray::number(len).size() + body.size() != len) {
+        len = QByteArray::number(len).size() + body.size();
+    }
+    return QByteArray::number(len) + body;
+}
+
+void appendTarHeader(QByteArray &out, const QByteArray &name, qint64 size, qint64 mtime, char type) {
+    char header[kTarBlock] = {};
+
+    // ustar 的 name 字段只有 100 字节，超出时尝试在 '/' 处拆到 155 字节的 prefix 中
+    if (name.size() <= 100) {
+        std::memcpy(header, name.constData(), name.size());
+    } else {
+        const int slash = name.lastIndexOf('/', 155);
+        if (slash > 0 && name.size() - slash - 1 <= 100) {
+            std::memcpy(header + 345, name.constData(), slash);
+            std::memcpy(header, name.constData() + slash + 1, name.size() - slash - 1);
+        } else {
+            std::memcpy(header, name.constData(), 100); // 完整名称已写入前面的 PAX 头
+        }
+    }
+
+    std::snprintf(header + 100, 8, "%07o", 0644);
+    std::snprintf(header + 108, 8, "%07o", 0);
+    std::snprintf(header + 116, 8, "%07o", 0);
+    std::snprintf(header + 124, 12, "%011llo", static_cast<unsigned long long>(size));
+    std::snprintf(header + 136, 12, "%011llo", static_cast<unsigned long long>(mtime));
+    std::memset(header + 148, ' ', 8);
+    header[156] = type;
+    std::memcpy(header + 257, "ustar", 6);
+    std::memcpy(header + 263, "00", 2);
+
+    unsigned sum = 0;
+    for (const char c : header) {
+        sum += static_cast<unsigned char>(c);
+    }
+    std::snprintf(header + 148, 8, "%06o", sum);
+    header[155] = ' ';
+
+    out.append(header, kTarBlock);
+}
+
+bool fitsUstar(const QByteArray &name) {
+    if (name.size() <= 100) {
+        return true;
+    }
+    const int slash = name.lastIndexOf('/', 155);
+    return slash > 0 && name.size() - slash - 1 <= 100;
+}
+
+} // namespace
+
+std::optional<ArchiveSink::Format> ArchiveSink::formatFromPath(const QString &path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == "zip") {
+        return Format::zip;
+    }
+    if (suffix == "tar") {
+        return Format::tar;
+    }
+    return std::nullopt;
+}
+
+std::unique_ptr<ArchiveSink> ArchiveSink::create(const QString &path, QString *errorString) {
+    const auto format = formatFromPath(path);
+    if (!format) {
+        if (errorString) {
+            *errorString = QStringLiteral("Unsupported archive format: %1").arg(path);
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<ArchiveSink> sink(new ArchiveSink(path, *format));
+    if (!sink->file_.open(QIODevice::WriteOnly)) {
+        if (errorString) {
+            *errorString = sink->file_.errorString();
+        }
+        spdlog::error("Failed to create archive {}: {}", path.toStdString(), sink->file_.errorString().toStdString());
+        return nullptr;
+    }
+    return sink;
+}
+
+ArchiveSink::ArchiveSink(const QString &path, Format format)
+    : format_(format), file_(path) {
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDate date = now.date();
+    const QTime time = now.time();
+    dosTime_ = static_cast<quint16>((time.hour() << 11) | (time.minute() << 5) | (time.second() / 2));
+    dosDate_ = static_cast<quint16>(((std::max(date.year(), 1980) - 1980) << 9) | (date.month() << 5) | date.day());
+    mtime_ = now.toSecsSinceEpoch();
+}
+
+ArchiveSink::Prepared ArchiveSink::prepare(const QString &name, const QByteArray &data) const {
+    Prepared entry;
+    entry.name = name.toUtf8();
+    if (format_ == Format::zip) {
+        entry.crc = static_cast<quint32>(
+            crc32(0L, reinterpret_cast<const Bytef *>(data.constData()), static_cast<uInt>(data.size())));
+    }
+    entry.sha256 = QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+    return entry;
+}
+
+std::vector<int> ArchiveSink::write(std::span<const OutputItem> items) {
+    // 校验和与摘要在锁外计算，各工作线程并行
+    std::vector<Prepared> prepared;
+    prepared.reserve(items.size());
+    qint64 total = 0;
+    for (const auto &item : items) {
+        prepared.push_back(prepare(item.name, item.data));
+        total += item.data.size() + 2 * kTarBlock;
+    }
+
+    std::lock_guard lock(mutex_);
+    if (failed_ || finished_) {
+        return std::vector<int>(items.size(), EIO);
+    }
+
+    QByteArray block;
+    block.reserve(static_cast<int>(std::min<qint64>(total, std::numeric_limits<int>::max())));
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        appendEntry(block, prepared[i], items[i].data, items[i].source);
+    }
+    if (!flush(block)) {
+        return std::vector<int>(items.size(), EIO);
+    }
+    return std::vector<int>(items.size(), 0);
+}
+
+void ArchiveSink::appendEntry(QByteArray &block,
+                              const Prepared &entry,
+                              const QByteArray &data,
+                              const QString &source) {
+    if (format_ == Format::zip) {
+        appendZipEntry(block, entry, data);
+    } else {
+        appendTarEntry(block, entry, data);
+    }
+    ++entries_;
+
+    manifest_.push_back({
+        {"name", entry.name.toStdString()},
+        {"source", source.toStdString()},
+        {"format", QFileInfo(QString::fromUtf8(entry.name)).suffix().toLower().toStdString()},
+        {"size", data.size()},
+        {"sha256", entry.sha256.toStdString()},
+    });
+}
+
+void ArchiveSink::appendZipEntry(QByteArray &block, const Prepared &entry, const QByteArray &data) {
+    const auto offset = static_cast<quint64>(written_ + block.size());
+    const auto size = static_cast<quint32>(data.size());
+    const auto nameSize = static_cast<quint16>(entry.name.size());
+
+    put32(block, kZipLocalHeader);
+    put16(block, kZipVersion);
+    put16(block, kZipUtf8Flag);
+    put16(block, 0); // stored
+    put16(block, dosTime_);
+    put16(block, dosDate_);
+    put32(block, entry.crc);
+    put32(block, size);
+    put32(block, size);
+    put16(block, nameSize);
+    put16(block, 0);
+    block.append(entry.name);
+    block.append(data);
+
+    // 单个条目不超过 2GB，只有偏移可能需要 ZIP64 扩展字段
+    const bool zip64 = offset >= kMax32;
+    put32(central_, kZipCentralHeader);
+    put16(central_, static_cast<quint16>((3 << 8) | kZip64Version)); // UNIX
+    put16(central_, zip64 ? kZip64Version : kZipVersion);
+    put16(central_, kZipUtf8Flag);
+    put16(central_, 0);
+    put16(central_, dosTime_);
+    put16(central_, dosDate_);
+    put32(central_, entry.crc);
+    put32(central_, size);
+    put32(central_, size);
+    put16(central_, nameSize);
+    put16(central_, zip64 ? 12 : 0);
+    put16(central_, 0); // comment
+    put16(central_, 0); // disk
+    put16(central_, 0); // internal attributes
+    put32(central_, 0100644u << 16);
+    put32(central_, zip64 ? kMax32 : static_cast<quint32>(offset));
+    central_.append(entry.name);
+    if (zip64) {
+        put16(central_, 0x0001);
+        put16(central_, 8);
+        put64(central_, offset);
+    }
+}
+
+void ArchiveSink::appendTarEntry(QByteArray &block, const Prepared &entry, const QByteArray &data) {
+    if (!fitsUstar(entry.name)) {
+        const QByteArray pax = paxRecord("path", entry.name);
+        appendTarHeader(block, "PaxHeaders/" + entry.name.right(80), pax.size(), mtime_, 'x');
+        block.append(pax);
+        padTar(block, pax.size());
+    }
+    appendTarHeader(block, entry.name, data.size(), mtime_, '0');
+    block.append(data);
+    padTar(block, data.size());
+}
+
+void ArchiveSink::appendZipDirectory(QByteArray &block) const {
+    const auto cdOffset = static_cast<quint64>(written_ + block.size());
+    const auto cdSize = static_cast<quint64>(central_.size());
+    block.append(central_);
+
+    if (entries_ >= kMax16 || cdOffset >= kMax32 || cdSize >= kMax32) {
+        const auto recordOffset = cdOffset + cdSize;
+        put32(block, kZip64EndRecord);
+        put64(block, 44);
+        put16(block, kZip64Version);
+        put16(block, kZip64Version);
+        put32(block, 0);
+        put32(block, 0);
+        put64(block, entries_);
+        put64(block, entries_);
+        put64(block, cdSize);
+        put64(block, cdOffset);
+
+        put32(block, kZip64EndLocator);
+        put32(block, 0);
+        put64(block, recordOffset);
+        put32(block, 1);
+    }
+
+    put32(block, kZipEndRecord);
+    put16(block, 0);
+    put16(block, 0);
+    put16(block, static_cast<quint16>(std::min<quint64>(entries_, kMax16)));
+    put16(block, static_cast<quint16>(std::min<quint64>(entries_, kMax16)));
+    put32(block, static_cast<quint32>(std::min<quint64>(cdSize, kMax32)));
+    put32(block, static_cast<quint32>(std::min<quint64>(cdOffset, kMax32)));
+    put16(block, 0);
+}
+
+bool ArchiveSink::flush(const QByteArray &block) {
+    if (file_.write(block) != block.size()) {
+        failed_ = true;
+        error_ = file_.errorString();
+        spdlog::error("Failed to write archive {}: {}", file_.fileName().toStdString(), error_.toStdString());
+        return false;
+    }
+    written_ += block.size();
+    return true;
+}
+
+bool ArchiveSink::finish() {
+    std::lock_guard lock(mutex_);
+    if (finished_) {
+        return !failed_;
+    }
+    finished_ = true;
+    if (failed_) {
+        file_.cancelWriting();
+        return false;
+    }
+
+    const QByteArray manifest = QByteArray::fromStdString(manifest_.dump(2));
+    QByteArray block;
+    appendEntry(block, prepare(QStringLiteral("manifest.json"), manifest), manifest, {});
+
+    if (format_ == Format::zip) {
+        appendZipDirectory(block);
+    } else {
+        block.append(2 * kTarBlock, '\0');
+    }
+
+    if (!flush(block) || !file_.commit()) {
+        failed_ = true;
+        if (error_.isEmpty()) {
+            error_ = file_.errorString();
+        }
+        return false;
+    }
+    spdlog::info("Archive {} written: {} entries, {} bytes", file_.fileName().toStdString(), entries_, written_);
+    return true;
+}
+
+QString ArchiveSink::location() const {
+    return file_.fileName();
+}
+
+QString ArchiveSink::errorString() const {
+    std::lock_guard lock(mutex_);
+    return error_;
+}
+
+} // namespace io
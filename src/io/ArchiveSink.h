@@ -0,0 +1,78 @@
+#pragma once
+
+#include "OutputSink.h"
+#include <QSaveFile>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+
+namespace io {
+
+/**
+ * @class ArchiveSink
+ * @brief 将整批结果流式写入单个 ZIP（仅存储）或 TAR 文件
+ *
+ * 各工作线程在锁外计算 CRC32 与 SHA-256，持锁时只把本块的头部和数据拼成一段连续写出。
+ * finish() 追加 manifest.json（源文件、格式、大小、SHA-256）并写入 ZIP 中央目录或 TAR 结束块，
+ * 之后才把临时文件替换为目标文件，因此中途失败或取消不会留下半个归档。
+ * 条目数、偏移超出 32 位时自动使用 ZIP64 记录。
+ */
+class ArchiveSink final : public OutputSink {
+public:
+    enum class Format {
+        zip,
+        tar,
+    };
+
+    /**
+     * @brief 根据后缀（.zip / .tar）判断归档格式
+     */
+    static std::optional<Format> formatFromPath(const QString &path);
+
+    /**
+     * @brief 创建归档
+     * @param path 归档文件路径，格式由后缀决定
+     * @param errorString 失败时写入原因，可为空
+     * @return 失败时返回 nullptr
+     */
+    static std::unique_ptr<ArchiveSink> create(const QString &path, QString *errorString = nullptr);
+
+    std::vector<int> write(std::span<const OutputItem> items) override;
+    bool finish() override;
+    QString location() const override;
+    QString errorString() const override;
+
+private:
+    struct Prepared {
+        QByteArray name;
+        quint32 crc = 0;
+        QByteArray sha256;
+    };
+
+    ArchiveSink(const QString &path, Format format);
+
+    void appendEntry(QByteArray &block, const Prepared &entry, const QByteArray &data, const QString &source);
+    void appendZipEntry(QByteArray &block, const Prepared &entry, const QByteArray &data);
+    void appendTarEntry(QByteArray &block, const Prepared &entry, const QByteArray &data);
+    void appendZipDirectory(QByteArray &block) const;
+    Prepared prepare(const QString &name, const QByteArray &data) const;
+    bool flush(const QByteArray &block);
+
+    const Format format_;
+    QSaveFile file_;
+    quint16 dosTime_ = 0;
+    quint16 dosDate_ = 0;
+    qint64 mtime_ = 0;
+
+    mutable std::mutex mutex_;
+    qint64 written_ = 0;
+    quint64 entries_ = 0;
+    QByteArray central_; /**< ZIP 中央目录，finish() 时一次写出 */
+    nlohmann::json manifest_ = nlohmann::json::array();
+    bool failed_ = false;
+    bool finished_ = false;
+    QString error_;
+};
+
+} // namespace io
@@ -0,0 +1,425 @@
+#include "BulkFileIO.h"
+#include <QFile>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <spdlog/spdlog.h>
+
+#if defined(LAB2QRCODE_HAVE_IO_URING)
+#include <fcntl.h>
+#include <liburing.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+namespace {
+
+FileBlob readWithQFile(const QString &path, qint64 maxSize) {
+    FileBlob blob;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        blob.error = file.error() == QFileDevice::OpenError ? ENOENT : EIO;
+        return blob;
+    }
+    if (file.size() > maxSize) {
+        blob.status = FileBlob::too_large;
+        return blob;
+    }
+    blob.data = file.readAll();
+    if (file.error() != QFileDevice::NoError) {
+        blob.data.clear();
+        blob.error = EIO;
+        return blob;
+    }
+    blob.status = FileBlob::ok;
+    return blob;
+}
+
+int writeWithQFile(const QString &path, const QByteArray &data) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return file.error() == QFileDevice::OpenError ? EACCES : EIO;
+    }
+    return file.write(data) == data.size() ? 0 : EIO;
+}
+
+#if defined(LAB2QRCODE_HAVE_IO_URING)
+
+constexpr unsigned kQueueDepth = 64;
+
+/**
+ * @brief 线程私有的 io_uring 实例，创建失败（内核过旧或被 seccomp 禁用）或缺少所需操作时回退到 QFile
+ */
+class Ring {
+public:
+    Ring() {
+        init();
+        if (ok_ && !supportsOps()) {
+            spdlog::warn("io_uring lacks openat/statx/read/write/close, falling back to QFile");
+            io_uring_queue_exit(&ring_);
+            ok_ = false;
+        }
+    }
+
+    ~Ring() {
+        if (ok_) {
+            io_uring_queue_exit(&ring_);
+        }
+    }
+
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    bool ok() const noexcept {
+        return ok_;
+    }
+
+    /**
+     * @brief 取一个提交项，提交队列已满时返回空指针
+     */
+    io_uring_sqe *sqe(std::uint64_t userData) {
+        io_uring_sqe *entry = io_uring_get_sqe(&ring_);
+        if (entry != nullptr) {
+            entry->user_data = userData;
+        }
+        return entry;
+    }
+
+    /**
+     * @brief 丢弃已准备但未提交的请求
+     */
+    void discard() {
+        rebuild();
+    }
+
+    /**
+     * @brief 提交已准备的请求并收割 count 个完成事件，res 以 user_data 为下标
+     *
+     * 已提交的请求无论成败都会全部收割，避免残留的完成事件被下一批误认；
+     * 出错时重建 io_uring，未提交的请求随之丢弃。
+     */
+    bool submitAndWait(unsigned count, std::vector<int> &res) {
+        if (count == 0) {
+            return true;
+        }
+        const int submitted = io_uring_submit_and_wait(&ring_, count);
+        bool ok = submitted == static_cast<int>(count);
+        for (int i = 0; i < submitted; ++i) {
+            io_uring_cqe *cqe = nullptr;
+            int ret = 0;
+            do {
+                ret = io_uring_wait_cqe(&ring_, &cqe);
+            } while (ret == -EINTR);
+            if (ret < 0) {
+                spdlog::warn("io_uring wait failed ({})", -ret);
+                rebuild();
+                return false;
+            }
+            if (cqe->user_data < res.size()) {
+                res[cqe->user_data] = cqe->res;
+            } else {
+                ok = false;
+            }
+            io_uring_cqe_seen(&ring_, cqe);
+        }
+        if (!ok) {
+            spdlog::warn("io_uring submit failed ({} of {} submitted)", submitted, count);
+            rebuild();
+        }
+        return ok;
+    }
+
+private:
+    void init() {
+        const int ret = io_uring_queue_init(kQueueDepth, &ring_, 0);
+        ok_ = ret == 0;
+        if (!ok_) {
+            spdlog::warn("io_uring unavailable ({}), falling back to QFile", -ret);
+        }
+    }
+
+    void rebuild() {
+        if (ok_) {
+            io_uring_queue_exit(&ring_);
+        }
+        init();
+    }
+
+    bool supportsOps() {
+        io_uring_probe *probe = io_uring_get_probe_ring(&ring_);
+        if (probe == nullptr) {
+            return false;
+        }
+        const bool supported = io_uring_opcode_supported(probe, IORING_OP_OPENAT) &&
+                               io_uring_opcode_supported(probe, IORING_OP_STATX) &&
+                               io_uring_opcode_supported(probe, IORING_OP_READ) &&
+                               io_uring_opcode_supported(probe, IORING_OP_WRITE) &&
+                               io_uring_opcode_supported(probe, IORING_OP_CLOSE);
+        io_uring_free_probe(probe);
+        return supported;
+    }
+
+    io_uring ring_{};
+    bool ok_ = false;
+};
+
+Ring &threadRing() {
+    thread_local Ring ring;
+    return ring;
+}
+
+/**
+ * @brief 关闭所有已打开的文件，io_uring 不可用或出错时对未确认关闭的文件调用 close(2)
+ */
+void closeAll(Ring &ring, const std::vector<int> &fds) {
+    constexpr int unreported = 1; // close 的结果只会是 0 或负的 errno
+    std::vector<int> res(fds.size(), unreported);
+    unsigned count = 0;
+    bool prepared = ring.ok();
+    for (std::size_t i = 0; prepared && i < fds.size(); ++i) {
+        if (fds[i] < 0) {
+            continue;
+        }
+        io_uring_sqe *entry = ring.sqe(i);
+        if (entry == nullptr) {
+            prepared = false;
+            break;
+        }
+        io_uring_prep_close(entry, fds[i]);
+        ++count;
+    }
+    if (!prepared) {
+        ring.discard();
+    } else {
+        ring.submitAndWait(count, res);
+    }
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+        if (fds[i] >= 0 && res[i] == unreported) {
+            ::close(fds[i]);
+        }
+    }
+}
+
+/**
+ * @brief 一批最多 kQueueDepth / 2 个文件：openat 与 statx 同批提交，随后一次提交全部 read，最后批量 close
+ */
+bool readBatch(Ring &ring, std::span<const QString> paths, qint64 maxSize, FileBlob *out) {
+    const std::size_t n = paths.size();
+    std::vector<QByteArray> names(n);
+    std::vector<struct statx> stats(n);
+    // 未收到完成事件的 openat 保持为 -ECANCELED，出错时不会被误当作文件描述符关闭
+    std::vector<int> res(n * 2, -ECANCELED);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        names[i] = QFile::encodeName(paths[i]);
+        io_uring_sqe *open = ring.sqe(i);
+        io_uring_sqe *stat = open != nullptr ? ring.sqe(n + i) : nullptr;
+        if (stat == nullptr) {
+            ring.discard();
+            return false;
+        }
+        io_uring_prep_openat(open, AT_FDCWD, names[i].constData(), O_RDONLY | O_CLOEXEC, 0);
+        io_uring_prep_statx(stat, AT_FDCWD, names[i].constData(), 0, STATX_SIZE, &stats[i]);
+    }
+    const bool opened = ring.submitAndWait(static_cast<unsigned>(n * 2), res);
+
+    std::vector<int> fds(n, -1);
+    std::vector<qint64> offsets(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        fds[i] = res[i];
+    }
+    if (!opened) {
+        closeAll(ring, fds);
+        return false;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (res[i] < 0 || res[n + i] < 0) {
+            out[i].error = res[i] < 0 ? -res[i] : -res[n + i];
+            continue;
+        }
+        const auto size = static_cast<qint64>(stats[i].stx_size);
+        if (size > maxSize) {
+            out[i].status = FileBlob::too_large;
+            continue;
+        }
+        out[i].data.resize(static_cast<int>(size));
+        out[i].status = FileBlob::ok;
+    }
+
+    // 普通文件通常一次读完，短读时只对剩余部分重新提交
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        unsigned count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (out[i].status == FileBlob::ok && offsets[i] < out[i].data.size()) {
+                io_uring_sqe *entry = ring.sqe(i);
+                if (entry == nullptr) {
+                    ring.discard();
+                    closeAll(ring, fds);
+                    return false;
+                }
+                io_uring_prep_read(entry,
+                                   fds[i],
+                                   out[i].data.data() + offsets[i],
+                                   static_cast<unsigned>(out[i].data.size() - offsets[i]),
+                                   static_cast<std::uint64_t>(offsets[i]));
+                ++count;
+            }
+        }
+        std::fill(res.begin(), res.end(), 0);
+        if (!ring.submitAndWait(count, res)) {
+            closeAll(ring, fds);
+            return false;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (out[i].status != FileBlob::ok || offsets[i] >= out[i].data.size()) {
+                continue;
+            }
+            if (res[i] < 0) {
+                out[i] = {FileBlob::failed, {}, -res[i]};
+            } else if (res[i] == 0) {
+                out[i].data.truncate(static_cast<int>(offsets[i])); // 文件在 statx 之后被截断
+            } else {
+                offsets[i] += res[i];
+                pending = true;
+            }
+        }
+    }
+
+    closeAll(ring, fds);
+    return true;
+}
+
+bool writeBatch(Ring &ring, std::span<const QString> paths, std::span<const QByteArray> data, int *out) {
+    const std::size_t n = paths.size();
+    std::vector<QByteArray> names(n);
+    std::vector<int> res(n, -ECANCELED);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        names[i] = QFile::encodeName(paths[i]);
+        io_uring_sqe *open = ring.sqe(i);
+        if (open == nullptr) {
+            ring.discard();
+            return false;
+        }
+        io_uring_prep_openat(open, AT_FDCWD, names[i].constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    const bool opened = ring.submitAndWait(static_cast<unsigned>(n), res);
+
+    std::vector<int> fds(res);
+    if (!opened) {
+        closeAll(ring, fds);
+        return false;
+    }
+    std::vector<qint64> offsets(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = fds[i] < 0 ? -fds[i] : 0;
+    }
+
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        unsigned count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (out[i] == 0 && offsets[i] < data[i].size()) {
+                io_uring_sqe *entry = ring.sqe(i);
+                if (entry == nullptr) {
+                    ring.discard();
+                    closeAll(ring, fds);
+                    return false;
+                }
+                io_uring_prep_write(entry,
+                                    fds[i],
+                                    data[i].constData() + offsets[i],
+                                    static_cast<unsigned>(data[i].size() - offsets[i]),
+                                    static_cast<std::uint64_t>(offsets[i]));
+                ++count;
+            }
+        }
+        std::fill(res.begin(), res.end(), 0);
+        if (!ring.submitAndWait(count, res)) {
+            closeAll(ring, fds);
+            return false;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (out[i] != 0 || offsets[i] >= data[i].size()) {
+                continue;
+            }
+            if (res[i] <= 0) {
+                out[i] = res[i] < 0 ? -res[i] : EIO;
+            } else {
+                offsets[i] += res[i];
+                pending = true;
+            }
+        }
+    }
+
+    closeAll(ring, fds);
+    return true;
+}
+
+#endif
+
+} // namespace
+
+std::vector<FileBlob> BulkFileIO::readFiles(std::span<const QString> paths, qint64 maxSize) {
+    std::vector<FileBlob> blobs(paths.size());
+
+#if defined(LAB2QRCODE_HAVE_IO_URING)
+    if (auto &ring = threadRing(); ring.ok()) {
+        constexpr std::size_t batch = kQueueDepth / 2;
+        bool ok = true;
+        for (std::size_t i = 0; ok && i < paths.size(); i += batch) {
+            const auto n = std::min(batch, paths.size() - i);
+            ok = readBatch(ring, paths.subspan(i, n), maxSize, blobs.data() + i);
+        }
+        if (ok) {
+            return blobs;
+        }
+        spdlog::warn("io_uring bulk read failed, retrying with QFile");
+    }
+#endif
+
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        blobs[i] = readWithQFile(paths[i], maxSize);
+    }
+    return blobs;
+}
+
+std::vector<int> BulkFileIO::writeFiles(std::span<const QString> paths, std::span<const QByteArray> data) {
+    std::vector<int> errors(paths.size(), 0);
+
+#if defined(LAB2QRCODE_HAVE_IO_URING)
+    if (auto &ring = threadRing(); ring.ok()) {
+        constexpr std::size_t batch = kQueueDepth;
+        bool ok = true;
+        for (std::size_t i = 0; ok && i < paths.size(); i += batch) {
+            const auto n = std::min(batch, paths.size() - i);
+            ok = writeBatch(ring, paths.subspan(i, n), data.subspan(i, n), errors.data() + i);
+        }
+        if (ok) {
+            return errors;
+        }
+        spdlog::warn("io_uring bulk write failed, retrying with QFile");
+    }
+#endif
+
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        errors[i] = writeWithQFile(paths[i], data[i]);
+    }
+    return errors;
+}
+
+const char *BulkFileIO::backendName() {
+#if defined(LAB2QRCODE_HAVE_IO_URING)
+    if (threadRing().ok()) {
+        return "io_uring";
+    }
+#endif
+    return "QFile";
+}
+
+} // namespace io
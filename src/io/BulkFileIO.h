@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <span>
+#include <vector>
+
+namespace io {
+
+/**
+ * @brief 批量读取的单个文件结果
+ */
+struct FileBlob {
+    enum status_t {
+        ok,        /**< 读取成功 */
+        failed,    /**< 打开或读取失败，error 为 errno */
+        too_large, /**< 超过调用方给定的大小上限，未读取 */
+    };
+
+    status_t status = failed;
+    QByteArray data;
+    int error = 0;
+};
+
+/**
+ * @class BulkFileIO
+ * @brief 面向大量小文件的批量读写
+ *
+ * Linux 下若编译时找到 liburing，则每个线程持有一个 io_uring，
+ * 一批文件的 openat/statx、read/write、close 各自只需一次提交，
+ * 免去逐个文件 open/stat/read/close 的系统调用开销。
+ * 其他平台或内核不支持 io_uring 时退化为在调用线程上逐个使用 QFile，
+ * 批处理引擎的各工作线程会并行调用，因此仍是多线程的。
+ */
+class BulkFileIO {
+public:
+    /**
+     * @brief 读取一组文件，结果与输入顺序一致
+     * @param paths 文件路径
+     * @param maxSize 单个文件的大小上限，超过的文件标记为 too_large 交由调用方处理
+     */
+    static std::vector<FileBlob> readFiles(std::span<const QString> paths, qint64 maxSize);
+
+    /**
+     * @brief 写入一组文件（覆盖已有文件）
+     * @param paths 目标路径
+     * @param data 每个文件的内容，与 paths 一一对应
+     * @return 每个文件的 errno，0 表示成功
+     */
+    static std::vector<int> writeFiles(std::span<const QString> paths, std::span<const QByteArray> data);
+
+    /**
+     * @brief 当前线程实际使用的后端名称，用于日志
+     */
+    static const char *backendName();
+};
+
+} // namespace io
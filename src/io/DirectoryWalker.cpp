@@ -0,0 +1,86 @@
+#include "DirectoryWalker.h"
+#include "ArchiveReader.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace io {
+
+namespace {
+
+bool hasImageMagic(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    char head[12] = {};
+    const auto n = file.read(head, sizeof(head));
+    const auto starts = [&](const char *magic, qint64 len, qint64 offset = 0) {
+        return n >= offset + len && std::memcmp(head + offset, magic, static_cast<std::size_t>(len)) == 0;
+    };
+    return starts("\x89PNG\r\n\x1a\n", 8) || starts("\xFF\xD8\xFF", 3) || starts("GIF8", 4) || starts("BM", 2) ||
+           starts("II*\0", 4) || starts("MM\0*", 4) || (starts("RIFF", 4) && starts("WEBP", 4, 8));
+}
+
+} // namespace
+
+InputKind classifyInput(const QString &path) {
+    static const QStringList imageSuffixes{"png", "jpg", "jpeg", "bmp", "gif", "tif", "tiff", "webp"};
+    static const QStringList dataSuffixes{"txt", "json", "rfa", "csv", "bin", "dat", "zip", "tar"};
+
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (imageSuffixes.contains(suffix)) {
+        return InputKind::image;
+    }
+    if (dataSuffixes.contains(suffix)) {
+        return InputKind::data;
+    }
+    return hasImageMagic(path) ? InputKind::image : InputKind::data;
+}
+
+qint64 walkDirectory(const QString &root,
+                     InputKind kind,
+                     const std::function<bool(std::vector<QString> &&)> &onBatch,
+                     const WalkOptions &options) {
+    using Clock = std::chrono::steady_clock;
+
+    qint64 found = 0;
+    std::vector<QString> batch;
+    batch.reserve(options.batchSize);
+    auto lastFlush = Clock::now();
+
+    const auto flush = [&] {
+        found += static_cast<qint64>(batch.size());
+        lastFlush = Clock::now();
+        const bool keepGoing = onBatch(std::move(batch));
+        batch = {};
+        batch.reserve(options.batchSize);
+        return keepGoing;
+    };
+
+    QDirIterator it(root, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const bool archive = options.includeArchives && ArchiveReader::isArchivePath(path);
+        if (!archive && classifyInput(path) != kind) {
+            continue;
+        }
+        batch.push_back(path);
+
+        // 凑满一批或距上次投递过久时立即投递，编码不必等遍历结束
+        if ((batch.size() >= options.batchSize || Clock::now() - lastFlush >= options.flushInterval) && !flush()) {
+            spdlog::info("Directory walk of {} stopped after {} files", root.toStdString(), found);
+            return found;
+        }
+    }
+    if (!batch.empty()) {
+        flush();
+    }
+
+    spdlog::info("Directory walk of {} finished: {} files", root.toStdString(), found);
+    return found;
+}
+
+} // namespace io
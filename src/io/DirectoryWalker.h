@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QString>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace io {
+
+/**
+ * @brief 输入文件的处理方式
+ */
+enum class InputKind {
+    image, /**< 图片，走解码 */
+    data,  /**< 其他文件，走生成 */
+};
+
+/**
+ * @brief 判断输入类型
+ *
+ * 优先按扩展名判断；扩展名未知时读取文件头的魔数识别常见图片格式，
+ * 因此没有扩展名的扫描图片也会被当作图片。
+ */
+InputKind classifyInput(const QString &path);
+
+/**
+ * @brief 目录遍历参数
+ */
+struct WalkOptions {
+    std::size_t batchSize = 512;                  /**< 每批回调的最大文件数 */
+    std::chrono::milliseconds flushInterval{50}; /**< 未凑满一批时的最长等待，保证处理尽早开始 */
+    bool includeArchives = false;                 /**< 不论 kind 同时返回 ZIP/TAR 归档，由调用方展开 */
+};
+
+/**
+ * @brief 递归遍历目录，筛选出指定类型的文件并分批回调
+ *
+ * 在调用线程上同步执行，调用方应放在独立线程中运行，不要占用批处理引擎所在的全局线程池。
+ * 不跟随符号链接，跳过隐藏文件。
+ * @param root 根目录
+ * @param kind 需要的文件类型
+ * @param onBatch 每批文件的回调，返回 false 时停止遍历
+ * @param options 遍历参数
+ * @return 找到的文件总数
+ */
+qint64 walkDirectory(const QString &root,
+                     InputKind kind,
+                     const std::function<bool(std::vector<QString> &&)> &onBatch,
+                     const WalkOptions &options = {});
+
+} // namespace io
@@ -0,0 +1,169 @@
+#include "HotFolderWatcher.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace io {
+
+namespace {
+
+/**
+ * @brief 常见的写入中临时文件：下载器、同步工具和办公软件的锁文件
+ */
+bool isTemporary(const QFileInfo &info) {
+    static const QStringList temporarySuffixes{"tmp", "part", "partial", "crdownload", "download", "swp"};
+
+    const QString name = info.fileName();
+    return name.endsWith('~') || name.startsWith("~$") || temporarySuffixes.contains(info.suffix().toLower());
+}
+
+/**
+ * @brief 列目录专用的线程池，全局线程池可能正被批处理引擎占满
+ */
+QThreadPool &listingPool() {
+    static QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    return pool;
+}
+
+} // namespace
+
+HotFolderWatcher::HotFolderWatcher(QString folder, WatchOptions options, QObject *parent)
+    : QObject(parent), folder_(QDir(folder).absolutePath()), options_(options) {
+    scanTimer_.setSingleShot(true);
+    connect(&watcher_, &QFileSystemWatcher::directoryChanged, this, &HotFolderWatcher::scheduleScan);
+    connect(&scanTimer_, &QTimer::timeout, this, &HotFolderWatcher::scan);
+    connect(&rescanTimer_, &QTimer::timeout, this, &HotFolderWatcher::scan);
+    connect(&listing_, &QFutureWatcherBase::finished, this, [this] {
+        apply(listing_.result());
+        if (std::exchange(rescanQueued_, false)) {
+            scan();
+        }
+    });
+}
+
+bool HotFolderWatcher::start() {
+    if (!QFileInfo(folder_).isDir()) {
+        spdlog::error("Hot folder does not exist: {}", folder_.toStdString());
+        return false;
+    }
+    if (!watcher_.addPath(folder_)) {
+        // 例如 inotify 监视数达到上限，此时只依赖定时扫描
+        spdlog::warn("Cannot watch {}, relying on periodic rescans", folder_.toStdString());
+    }
+
+    clock_.start();
+    rescanTimer_.start(options_.rescanInterval);
+    spdlog::info("Watching hot folder {}", folder_.toStdString());
+    scan();
+    return true;
+}
+
+void HotFolderWatcher::stop() {
+    if (!watcher_.directories().isEmpty()) {
+        watcher_.removePaths(watcher_.directories());
+    }
+    scanTimer_.stop();
+    rescanTimer_.stop();
+    rescanQueued_ = false;
+    pending_.clear();
+    spdlog::info("Stopped watching hot folder {}", folder_.toStdString());
+}
+
+void HotFolderWatcher::scheduleScan() {
+    // 不重启计时器：持续的通知流也不会把扫描无限推迟
+    if (!scanTimer_.isActive()) {
+        scanTimer_.start(options_.debounce);
+    }
+}
+
+void HotFolderWatcher::scan() {
+    if (!rescanTimer_.isActive()) {
+        return; // 已停止
+    }
+    // 目录被删除后重建时重新加入监视
+    if (watcher_.directories().isEmpty() && QFileInfo(folder_).isDir()) {
+        watcher_.addPath(folder_);
+    }
+
+    if (listing_.isRunning()) {
+        rescanQueued_ = true;
+        return;
+    }
+    listing_.setFuture(QtConcurrent::run(&listingPool(), [folder = folder_] { return list(folder); }));
+}
+
+HotFolderWatcher::Listing HotFolderWatcher::list(const QString &folder) {
+    Listing listing;
+    QDirIterator it(folder, QDir::Files | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QFileInfo info = it.fileInfo();
+        if (!isTemporary(info)) {
+            listing.append({path, {info.size(), info.lastModified().toMSecsSinceEpoch()}});
+        }
+    }
+    return listing;
+}
+
+void HotFolderWatcher::apply(const Listing &listing) {
+    if (!rescanTimer_.isActive()) {
+        return; // 列目录期间已停止
+    }
+
+    const qint64 now = clock_.elapsed();
+    const qint64 settle = options_.settle.count();
+    QStringList ready;
+    QSet<QString> present;
+    bool settling = false;
+
+    for (const auto &[path, stamp] : listing) {
+        present.insert(path);
+
+        if (const auto done = delivered_.constFind(path); done != delivered_.cend() && *done == stamp) {
+            continue;
+        }
+
+        auto pending = pending_.find(path);
+        if (pending == pending_.end() || pending->stamp != stamp) {
+            pending_.insert(path, {stamp, now});
+            settling = true;
+            continue;
+        }
+        if (stamp.size == 0) {
+            continue; // 空文件通常是刚创建、尚未写入，等下次变更通知
+        }
+        if (now - pending->since < settle) {
+            settling = true;
+            continue;
+        }
+
+        ready.append(path);
+        delivered_.insert(path, stamp);
+        pending_.erase(pending);
+    }
+
+    // 已删除的文件不再跟踪，之后出现的同名文件会重新投递
+    for (auto i = pending_.begin(); i != pending_.end();) {
+        i = present.contains(i.key()) ? std::next(i) : pending_.erase(i);
+    }
+    for (auto i = delivered_.begin(); i != delivered_.end();) {
+        i = present.contains(i.key()) ? std::next(i) : delivered_.erase(i);
+    }
+
+    if (settling && !scanTimer_.isActive()) {
+        scanTimer_.start(options_.settle);
+    }
+    if (!ready.isEmpty()) {
+        spdlog::debug("Hot folder {}: {} new files", folder_.toStdString(), ready.size());
+        emit filesReady(ready);
+    }
+}
+
+} // namespace io
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <chrono>
+
+namespace io {
+
+/**
+ * @brief 监视文件夹参数
+ */
+struct WatchOptions {
+    std::chrono::milliseconds debounce{100};        /**< 收到变更通知后延迟扫描的时间，合并突发的大量通知 */
+    std::chrono::milliseconds settle{300};          /**< 大小和修改时间保持不变多久后才认为文件已写完 */
+    std::chrono::milliseconds rescanInterval{5000}; /**< 定时全量扫描的间隔，兜底丢失的通知 */
+};
+
+/**
+ * @class HotFolderWatcher
+ * @brief 监视单个文件夹（不递归），新文件写完后分批发出 filesReady
+ *
+ * 变更通知（Linux 上为 inotify）只用来触发扫描，是否有新文件以扫描结果为准：
+ * 每次扫描列出整个目录并与上次的大小、修改时间比较，因此通知队列溢出或合并都不会漏掉文件，
+ * 定时全量扫描再兜底一次。列目录和读取文件状态在后台线程进行，结果回到本对象所在线程比较，
+ * 同一时间只有一次列目录在进行，期间到来的扫描请求合并为结束后的一次。
+ * 文件在连续两次扫描中大小和修改时间都不变且间隔超过 settle 才投递，避免处理写了一半的文件；
+ * 空文件、隐藏文件以及 .tmp/.part 等临时文件不投递。
+ * 启动时目录中已有的文件同样会被投递；已投递的文件再次被修改时重新投递。
+ */
+class HotFolderWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HotFolderWatcher(QString folder, WatchOptions options = {}, QObject *parent = nullptr);
+
+    /**
+     * @brief 开始监视并立即扫描一次
+     * @return 目录不存在或无法监视时返回 false
+     */
+    bool start();
+
+    /**
+     * @brief 停止监视，已投递的文件不受影响
+     */
+    void stop();
+
+    QString folder() const {
+        return folder_;
+    }
+
+signals:
+    /**
+     * @brief 一批已写完的新文件
+     * @param paths 文件的绝对路径
+     */
+    void filesReady(const QStringList &paths);
+
+private:
+    /**
+     * @brief 文件的大小与修改时间，用于判断文件是否仍在写入
+     */
+    struct Stamp {
+        qint64 size = -1;
+        qint64 mtime = 0;
+
+        bool operator==(const Stamp &) const = default;
+    };
+
+    /**
+     * @brief 列目录得到的一个文件
+     */
+    struct Entry {
+        QString path;
+        Stamp stamp;
+    };
+
+    using Listing = QVector<Entry>;
+
+    /**
+     * @brief 仍在观察的文件，since 为最近一次变化被观察到的时间
+     */
+    struct Pending {
+        Stamp stamp;
+        qint64 since = 0;
+    };
+
+    void scheduleScan();
+    void scan();
+
+    /**
+     * @brief 列出目录中的文件及其状态，跳过临时文件，在后台线程执行
+     */
+    static Listing list(const QString &folder);
+
+    /**
+     * @brief 将列目录的结果与上次比较，投递已写完的文件
+     */
+    void apply(const Listing &listing);
+
+    const QString folder_;
+    const WatchOptions options_;
+    QFileSystemWatcher watcher_;
+    QTimer scanTimer_;
+    QTimer rescanTimer_;
+    QElapsedTimer clock_;
+    QFutureWatcher<Listing> listing_; /**< 进行中的列目录 */
+    bool rescanQueued_ = false;       /**< 列目录期间又收到了扫描请求 */
+    QHash<QString, Pending> pending_; /**< 尚未稳定的文件 */
+    QHash<QString, Stamp> delivered_; /**< 已投递的文件及投递时的状态 */
+};
+
+} // namespace io
@@ -0,0 +1,79 @@
+#include "MappedInput.h"
+#include <SimpleBase64.h>
+#include <utility>
+
+namespace io {
+
+MappedInput::MappedInput(MappedInput &&other) noexcept
+    : file_(std::move(other.file_)),
+      mapped_(std::exchange(other.mapped_, nullptr)),
+      buffer_(std::move(other.buffer_)),
+      size_(std::exchange(other.size_, 0)),
+      open_(std::exchange(other.open_, false)),
+      error_(std::move(other.error_)) {}
+
+MappedInput &MappedInput::operator=(MappedInput &&other) noexcept {
+    if (this != &other) {
+        if (mapped_ && file_) {
+            file_->unmap(mapped_);
+        }
+        file_ = std::move(other.file_);
+        mapped_ = std::exchange(other.mapped_, nullptr);
+        buffer_ = std::move(other.buffer_);
+        size_ = std::exchange(other.size_, 0);
+        open_ = std::exchange(other.open_, false);
+        error_ = std::move(other.error_);
+    }
+    return *this;
+}
+
+MappedInput::~MappedInput() {
+    if (mapped_ && file_) {
+        file_->unmap(mapped_);
+    }
+}
+
+MappedInput MappedInput::open(const QString &path) {
+    MappedInput input;
+    input.file_ = std::make_unique<QFile>(path);
+    if (!input.file_->open(QIODevice::ReadOnly)) {
+        input.error_ = input.file_->errorString();
+        return input;
+    }
+
+    const qint64 size = input.file_->size();
+    if (size >= kMapThreshold) {
+        input.mapped_ = input.file_->map(0, size);
+    }
+
+    if (input.mapped_) {
+        input.size_ = static_cast<std::size_t>(size);
+    } else {
+        // 小文件、管道或不支持映射的文件系统，读取一次
+        input.buffer_ = input.file_->readAll();
+        input.size_ = static_cast<std::size_t>(input.buffer_.size());
+        input.file_->close();
+    }
+    input.open_ = true;
+    return input;
+}
+
+const std::uint8_t *MappedInput::data() const noexcept {
+    if (mapped_) {
+        return mapped_;
+    }
+    return reinterpret_cast<const std::uint8_t *>(buffer_.constData());
+}
+
+std::string encodeTransport(const std::uint8_t *data, std::size_t size, bool useBase64) {
+    if (!useBase64) {
+        return {reinterpret_cast<const char *>(data), size};
+    }
+
+    std::string text;
+    text.resize(SimpleBase64::encoded_size(size));
+    SimpleBase64::encode_to(data, size, text.data());
+    return text;
+}
+
+} // namespace io
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace io {
+
+/**
+ * @brief 小于该大小的文件直接读取，映射的系统调用和缺页开销反而更大
+ */
+inline constexpr qint64 kMapThreshold = 64 * 1024;
+
+/**
+ * @class MappedInput
+ * @brief 只读的输入文件视图
+ *
+ * 大文件通过 QFile::map 映射到内存，读取时不产生额外拷贝；小文件回退为一次 readAll。
+ * 对象析构时自动解除映射并关闭文件，data() 返回的指针在此之前一直有效。
+ */
+class MappedInput {
+public:
+    MappedInput() = default;
+    MappedInput(MappedInput &&other) noexcept;
+    MappedInput &operator=(MappedInput &&other) noexcept;
+    MappedInput(const MappedInput &) = delete;
+    MappedInput &operator=(const MappedInput &) = delete;
+    ~MappedInput();
+
+    /**
+     * @brief 打开文件
+     * @param path 文件路径
+     * @return 打开失败时 isOpen() 为 false，errorString() 给出原因
+     */
+    static MappedInput open(const QString &path);
+
+    bool isOpen() const noexcept {
+        return open_;
+    }
+
+    bool isMapped() const noexcept {
+        return mapped_ != nullptr;
+    }
+
+    const std::uint8_t *data() const noexcept;
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    std::string_view view() const noexcept {
+        return {reinterpret_cast<const char *>(data()), size_};
+    }
+
+    const QString &errorString() const noexcept {
+        return error_;
+    }
+
+private:
+    std::unique_ptr<QFile> file_;
+    uchar *mapped_ = nullptr;
+    QByteArray buffer_;
+    std::size_t size_ = 0;
+    bool open_ = false;
+    QString error_;
+};
+
+/**
+ * @brief 将输入字节编码为条码的传输文本
+ *
+ * Base64 模式直接写入预先分配好大小的字符串，原样模式只做一次拷贝，
+ * 输入数据在交给 ZXing 之前只被读取一遍。
+ * @param data 输入数据
+ * @param size 输入长度
+ * @param useBase64 是否进行 Base64 编码
+ */
+std::string encodeTransport(const std::uint8_t *data, std::size_t size, bool useBase64);
+
+} // namespace io
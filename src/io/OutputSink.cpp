@@ -0,0 +1,36 @@
+#include "OutputSink.h"
+#include "BulkFileIO.h"
+#include <QDir>
+#include <utility>
+
+namespace io {
+
+DirectorySink::DirectorySink(QString root)
+    : root_(std::move(root)) {}
+
+std::vector<int> DirectorySink::write(std::span<const OutputItem> items) {
+    const QDir dir(root_);
+    std::vector<QString> paths;
+    std::vector<QByteArray> contents;
+    paths.reserve(items.size());
+    contents.reserve(items.size());
+    for (const auto &item : items) {
+        paths.push_back(dir.filePath(item.name));
+        contents.push_back(item.data);
+    }
+    return BulkFileIO::writeFiles(paths, contents);
+}
+
+bool DirectorySink::finish() {
+    return true;
+}
+
+QString DirectorySink::location() const {
+    return root_;
+}
+
+QString DirectorySink::errorString() const {
+    return {};
+}
+
+} // namespace io
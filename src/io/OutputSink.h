@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <span>
+#include <vector>
+
+namespace io {
+
+/**
+ * @brief 待写出的单个结果
+ */
+struct OutputItem {
+    QString name;    /**< 相对输出位置的文件名，绝对路径时按原样使用（仅目录输出） */
+    QByteArray data; /**< 已编码好的文件内容 */
+    QString source;  /**< 源文件路径，写入归档清单 */
+};
+
+/**
+ * @class OutputSink
+ * @brief 批处理结果的输出目标
+ *
+ * 保存流水线的各工作线程按块并发调用 write()，全部写完后由调用方调用一次 finish()。
+ * 只依赖 QtCore，不涉及任何界面。
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief 写入一块结果，线程安全
+     * @return 每个条目的 errno，0 表示成功
+     */
+    virtual std::vector<int> write(std::span<const OutputItem> items) = 0;
+
+    /**
+     * @brief 结束输出，归档在此写入清单和目录
+     * @return 输出是否完整
+     */
+    virtual bool finish() = 0;
+
+    /**
+     * @brief 输出位置（目录或归档文件路径），用于提示
+     */
+    virtual QString location() const = 0;
+
+    /**
+     * @brief 最近一次失败的原因
+     */
+    virtual QString errorString() const = 0;
+};
+
+/**
+ * @class DirectorySink
+ * @brief 每个结果写成目录下的一个文件，经 BulkFileIO 批量写出
+ */
+class DirectorySink final : public OutputSink {
+public:
+    explicit DirectorySink(QString root);
+
+    std::vector<int> write(std::span<const OutputItem> items) override;
+    bool finish() override;
+    QString location() const override;
+    QString errorString() const override;
+
+private:
+    const QString root_;
+};
+
+} // namespace io
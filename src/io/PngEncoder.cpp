@@ -0,0 +1,257 @@
+#include "PngEncoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <vector>
+#include <zlib.h>
+
+#ifdef LAB2QRCODE_HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+namespace io {
+
+namespace {
+
+enum ColorType : quint8 {
+    gray = 0,
+    rgb = 2,
+    palette = 3,
+    rgba = 6,
+};
+
+void appendBigEndian(QByteArray &out, quint32 value) {
+    const char bytes[4] = {static_cast<char>(value >> 24),
+                           static_cast<char>(value >> 16),
+                           static_cast<char>(value >> 8),
+                           static_cast<char>(value)};
+    out.append(bytes, 4);
+}
+
+void appendChunk(QByteArray &png, const char *type, const QByteArray &data) {
+    appendBigEndian(png, static_cast<quint32>(data.size()));
+    const int start = png.size();
+    png.append(type, 4);
+    png.append(data);
+    const auto crc = crc32(0, reinterpret_cast<const Bytef *>(png.constData() + start), png.size() - start);
+    appendBigEndian(png, static_cast<quint32>(crc));
+}
+
+uchar paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<uchar>(a);
+    }
+    return static_cast<uchar>(pb <= pc ? b : c);
+}
+
+/**
+ * @brief 用第 type 种滤波器处理一行，prev 为上一行的原始数据（第一行为全零）
+ */
+void applyFilter(int type, const uchar *row, const uchar *prev, int length, int bpp, uchar *out) {
+    for (int i = 0; i < length; ++i) {
+        const int a = i >= bpp ? row[i - bpp] : 0;
+        const int b = prev[i];
+        const int c = i >= bpp ? prev[i - bpp] : 0;
+        int predictor = 0;
+        switch (type) {
+        case 1: predictor = a; break;
+        case 2: predictor = b; break;
+        case 3: predictor = (a + b) / 2; break;
+        case 4: predictor = paeth(a, b, c); break;
+        default: break;
+        }
+        out[i] = static_cast<uchar>(row[i] - predictor);
+    }
+}
+
+/**
+ * @brief 按 libpng 的启发式，选择差值绝对值之和最小的滤波器
+ */
+void filterRow(const uchar *row, const uchar *prev, int length, int bpp, uchar *out) {
+    thread_local std::vector<uchar> candidate;
+    candidate.resize(static_cast<std::size_t>(length));
+
+    long best = -1;
+    for (int type = 0; type < 5; ++type) {
+        applyFilter(type, row, prev, length, bpp, candidate.data());
+        long sum = 0;
+        for (int i = 0; i < length && (best < 0 || sum < best); ++i) {
+            sum += std::abs(static_cast<int>(static_cast<signed char>(candidate[i])));
+        }
+        if (best < 0 || sum < best) {
+            best = sum;
+            out[0] = static_cast<uchar>(type);
+            std::memcpy(out + 1, candidate.data(), candidate.size());
+        }
+    }
+}
+
+QByteArray deflateData(const std::vector<uchar> &data, const PngOptions &options) {
+    const int level = std::clamp(options.level, 0, 9);
+
+#ifdef LAB2QRCODE_HAVE_LIBDEFLATE
+    // 压缩器按线程缓存，级别变化时重建
+    struct Compressor {
+        int level = -1;
+        libdeflate_compressor *handle = nullptr;
+
+        ~Compressor() {
+            if (handle) {
+                libdeflate_free_compressor(handle);
+            }
+        }
+    };
+    thread_local Compressor compressor;
+    if (compressor.level != level) {
+        if (compressor.handle) {
+            libdeflate_free_compressor(compressor.handle);
+        }
+        compressor.handle = libdeflate_alloc_compressor(level);
+        compressor.level = level;
+    }
+    if (compressor.handle) {
+        QByteArray out(static_cast<int>(libdeflate_zlib_compress_bound(compressor.handle, data.size())),
+                       Qt::Uninitialized);
+        const auto size = libdeflate_zlib_compress(
+            compressor.handle, data.data(), data.size(), out.data(), static_cast<std::size_t>(out.size()));
+        if (size > 0) {
+            out.resize(static_cast<int>(size));
+            return out;
+        }
+    }
+#endif
+
+    // 不滤波时数据多为整字节的长串 0x00/0xFF，按行程压缩比通用策略快得多
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15, 9, options.filter ? Z_DEFAULT_STRATEGY : Z_RLE) != Z_OK) {
+        return {};
+    }
+    QByteArray out(static_cast<int>(deflateBound(&stream, static_cast<uLong>(data.size()))), Qt::Uninitialized);
+    stream.next_in = const_cast<Bytef *>(data.data());
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int rc = deflate(&stream, Z_FINISH);
+    out.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    return rc == Z_STREAM_END ? out : QByteArray();
+}
+
+} // namespace
+
+bool PngEncoder::isBilevel(const QImage &image) {
+    if (image.format() != QImage::Format_Grayscale8) {
+        return image.format() == QImage::Format_Mono || image.format() == QImage::Format_MonoLSB;
+    }
+    for (int y = 0; y < image.height(); ++y) {
+        const uchar *line = image.constScanLine(y);
+        for (int x = 0; x < image.width(); ++x) {
+            if (line[x] != 0x00 && line[x] != 0xFF) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QByteArray PngEncoder::encode(const QImage &image, const PngOptions &options) {
+    if (image.isNull()) {
+        return {};
+    }
+
+    QImage source = image;
+    ColorType colorType = gray;
+    if (isBilevel(image)) {
+        colorType = palette;
+        if (source.format() != QImage::Format_Grayscale8) {
+            source = source.convertToFormat(QImage::Format_Grayscale8);
+        }
+    } else if (source.format() == QImage::Format_Grayscale8) {
+        colorType = gray;
+    } else if (source.hasAlphaChannel()) {
+        colorType = rgba;
+        source = source.convertToFormat(QImage::Format_RGBA8888);
+    } else {
+        colorType = rgb;
+        source = source.convertToFormat(QImage::Format_RGB888);
+    }
+
+    const int width = source.width();
+    const int height = source.height();
+    const int channels = colorType == rgba ? 4 : colorType == rgb ? 3 : 1;
+    const int rowBytes = colorType == palette ? (width + 7) / 8 : width * channels;
+    const int bpp = channels; // 滤波器按字节计的像素间距，位深小于 8 时取 1
+
+    std::vector<uchar> filtered(static_cast<std::size_t>(rowBytes + 1) * height);
+    std::vector<uchar> packed(static_cast<std::size_t>(rowBytes));
+    std::vector<uchar> previous(static_cast<std::size_t>(rowBytes), 0);
+    for (int y = 0; y < height; ++y) {
+        const uchar *line = source.constScanLine(y);
+        const uchar *row = line;
+        if (colorType == palette) {
+            // 调色板 0 为黑、1 为白，每字节 8 个像素，高位在前
+            std::fill(packed.begin(), packed.end(), 0);
+            for (int x = 0; x < width; ++x) {
+                if (line[x] != 0) {
+                    packed[x >> 3] |= static_cast<uchar>(0x80 >> (x & 7));
+                }
+            }
+            row = packed.data();
+        }
+
+        uchar *out = filtered.data() + static_cast<std::size_t>(y) * (rowBytes + 1);
+        if (options.filter) {
+            filterRow(row, previous.data(), rowBytes, bpp, out);
+            std::memcpy(previous.data(), row, static_cast<std::size_t>(rowBytes));
+        } else {
+            out[0] = 0;
+            std::memcpy(out + 1, row, static_cast<std::size_t>(rowBytes));
+        }
+    }
+
+    const QByteArray idat = deflateData(filtered, options);
+    if (idat.isEmpty()) {
+        spdlog::error("PNG deflate failed for {}x{} image", width, height);
+        return {};
+    }
+
+    QByteArray png("\x89PNG\r\n\x1a\n", 8);
+    png.reserve(idat.size() + 128);
+
+    QByteArray header;
+    appendBigEndian(header, static_cast<quint32>(width));
+    appendBigEndian(header, static_cast<quint32>(height));
+    header.append(static_cast<char>(colorType == palette ? 1 : 8)); // 位深
+    header.append(static_cast<char>(colorType));
+    header.append(3, '\0'); // 压缩方法、滤波方法、不隔行
+    appendChunk(png, "IHDR", header);
+
+    if (colorType == palette) {
+        appendChunk(png, "PLTE", QByteArray("\x00\x00\x00\xFF\xFF\xFF", 6));
+    }
+    if (image.dotsPerMeterX() > 0 && image.dotsPerMeterY() > 0) {
+        QByteArray physical;
+        appendBigEndian(physical, static_cast<quint32>(image.dotsPerMeterX()));
+        appendBigEndian(physical, static_cast<quint32>(image.dotsPerMeterY()));
+        physical.append('\x01'); // 单位：米
+        appendChunk(png, "pHYs", physical);
+    }
+    appendChunk(png, "IDAT", idat);
+    appendChunk(png, "IEND", {});
+    return png;
+}
+
+const char *PngEncoder::backendName() {
+#ifdef LAB2QRCODE_HAVE_LIBDEFLATE
+    return "libdeflate";
+#else
+    return "zlib";
+#endif
+}
+
+} // namespace io
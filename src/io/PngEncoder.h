@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+
+namespace io {
+
+/**
+ * @brief PNG 编码参数
+ */
+struct PngOptions {
+    int level = 6;      /**< deflate 压缩级别，0（不压缩）到 9 */
+    bool filter = true; /**< 逐行自适应选择滤波器；false 为快速模式，不滤波且按行程压缩 */
+};
+
+/**
+ * @class PngEncoder
+ * @brief 针对条码图片的 PNG 编码器
+ *
+ * 只含纯黑、纯白两种像素的图片写为 1 位调色板 PNG，数据量是 8 位灰度的 1/8，
+ * 压缩和写入都相应变快；其他灰度图写为 8 位灰度，彩色图写为 RGB/RGBA。
+ * 保留图片的 DPI（pHYs），与 QImage::save 的结果在看图软件和打印时一致。
+ *
+ * 编译时找到 libdeflate 则用它压缩（每个线程缓存一个压缩器），否则使用 zlib。
+ * 函数不共享可变状态，可在多个工作线程上并发调用。
+ */
+class PngEncoder {
+public:
+    /**
+     * @brief 编码为 PNG 文件内容
+     * @return 空图片或压缩失败时返回空
+     */
+    static QByteArray encode(const QImage &image, const PngOptions &options = {});
+
+    /**
+     * @brief 图片是否只含纯黑和纯白
+     */
+    static bool isBilevel(const QImage &image);
+
+    /**
+     * @brief 实际使用的压缩库名称，用于日志
+     */
+    static const char *backendName();
+};
+
+} // namespace io
@@ -0,0 +1,197 @@
+#include "PrintSheet.h"
+#include "../batch/MemoryBudget.h"
+#include <QFont>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace io {
+
+namespace {
+
+constexpr double kMmPerInch = 25.4;
+
+int fit(double available, double cell, double gap) {
+    if (cell <= 0 || available < cell) {
+        return 0;
+    }
+    return static_cast<int>(std::floor((available + gap) / (cell + gap)));
+}
+
+} // namespace
+
+int SheetLayout::columns() const {
+    const double width = QPageSize(pageSize).size(QPageSize::Millimeter).width() - margins.left() - margins.right();
+    return fit(width, labelSize.width(), gap);
+}
+
+int SheetLayout::rows() const {
+    const double height = QPageSize(pageSize).size(QPageSize::Millimeter).height() - margins.top() - margins.bottom();
+    return fit(height, labelSize.height() + captionHeight, gap);
+}
+
+PrintSheetWriter::PrintSheetWriter(SheetLayout layout, std::shared_ptr<batch::MemoryBudget> budget)
+    : layout_(std::move(layout)), budget_(std::move(budget)) {}
+
+int PrintSheetWriter::pageCount(std::size_t labelCount) const {
+    const auto perPage = static_cast<std::size_t>(layout_.labelsPerPage());
+    return perPage > 0 ? static_cast<int>((labelCount + perPage - 1) / perPage) : 0;
+}
+
+int PrintSheetWriter::toPixels(double mm) const {
+    return static_cast<int>(std::lround(mm * layout_.dpi / kMmPerInch));
+}
+
+QRect PrintSheetWriter::labelRect(int slot) const {
+    const int column = slot % layout_.columns();
+    const int row = slot / layout_.columns();
+    // 位置和尺寸分别取整，所有标签的像素尺寸相同
+    const double x = layout_.margins.left() + column * (layout_.labelSize.width() + layout_.gap);
+    const double y = layout_.margins.top() + row * (layout_.labelSize.height() + layout_.captionHeight + layout_.gap);
+    return {toPixels(x), toPixels(y), toPixels(layout_.labelSize.width()), toPixels(layout_.labelSize.height())};
+}
+
+QRect PrintSheetWriter::captionRect(int slot) const {
+    const QRect label = labelRect(slot);
+    return {label.left(), label.bottom() + 1, label.width(), toPixels(layout_.captionHeight)};
+}
+
+QImage PrintSheetWriter::renderPage(std::span<const SheetLabel> labels) const {
+    QImage page(QPageSize(layout_.pageSize).sizePixels(layout_.dpi), QImage::Format_Grayscale8);
+    page.fill(Qt::white);
+    {
+        // 不开启平滑缩放，按最近邻取样
+        QPainter painter(&page);
+        for (std::size_t slot = 0; slot < labels.size(); ++slot) {
+            if (!labels[slot].image.isNull()) {
+                painter.drawImage(labelRect(static_cast<int>(slot)), labels[slot].image);
+            }
+        }
+    }
+    // 条码只有黑白两色，1 位图在 PDF 中的体积约为灰度图的 1/8
+    return page.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
+}
+
+bool PrintSheetWriter::write(const QString &path, std::span<const SheetLabel> labels, const Progress &progress) {
+    error_.clear();
+    const int perPage = layout_.labelsPerPage();
+    if (perPage <= 0) {
+        error_ = QStringLiteral("Label does not fit on the page");
+        return false;
+    }
+    const int pages = pageCount(labels.size());
+    if (pages == 0) {
+        error_ = QStringLiteral("Nothing to print");
+        return false;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error_ = file.errorString();
+        return false;
+    }
+    QPdfWriter pdf(&file);
+    pdf.setCreator(QStringLiteral("Lab2QRCode"));
+    pdf.setPageSize(QPageSize(layout_.pageSize));
+    pdf.setPageMargins(QMarginsF(0, 0, 0, 0));
+    pdf.setResolution(layout_.dpi);
+
+    QPainter painter;
+    if (!painter.begin(&pdf)) {
+        error_ = QStringLiteral("Cannot start PDF output");
+        return false;
+    }
+    QFont font;
+    font.setPixelSize(std::max(1, toPixels(layout_.captionHeight * 0.75)));
+    painter.setFont(font);
+    const QFontMetrics metrics = painter.fontMetrics();
+
+    const auto pageLabels = [&](int page) {
+        const auto first = static_cast<std::size_t>(page) * perPage;
+        return labels.subspan(first, std::min<std::size_t>(perPage, labels.size() - first));
+    };
+
+    // 后面的页在线程池中栅格化，当前页按顺序写入，最多同时保留 window 页
+    struct Rendering {
+        QFuture<QImage> image;
+        batch::MemoryBudget::Permit permit;
+    };
+    const QSize pagePixels = QPageSize(layout_.pageSize).sizePixels(layout_.dpi);
+    // 灰度画布加转换后的 1 位图
+    const auto pageBytes = static_cast<std::size_t>(pagePixels.width()) * pagePixels.height() * 9 / 8;
+    const auto window = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount() * 2));
+    std::deque<Rendering> inFlight;
+    int scheduled = 0;
+    const auto schedule = [&] {
+        batch::MemoryBudget::Permit permit;
+        if (budget_) {
+            // 手上没有页面时可以等待；已有页面在途时只尝试申请，避免持有许可等待而死锁
+            if (inFlight.empty()) {
+                permit = budget_->acquire(pageBytes);
+            } else if (auto granted = budget_->tryAcquire(pageBytes)) {
+                permit = std::move(*granted);
+            } else {
+                return false;
+            }
+        }
+        inFlight.push_back(
+            {QtConcurrent::run([this, page = pageLabels(scheduled)] { return renderPage(page); }), std::move(permit)});
+        ++scheduled;
+        return true;
+    };
+
+    bool canceled = false;
+    for (int page = 0; page < pages && !canceled; ++page) {
+        while (scheduled < pages && inFlight.size() < window && schedule()) {
+        }
+        const Rendering rendering = std::move(inFlight.front());
+        inFlight.pop_front();
+        const QImage image = rendering.image.result();
+
+        if (page > 0) {
+            pdf.newPage();
+        }
+        painter.drawImage(QPoint(0, 0), image);
+        const auto onPage = pageLabels(page);
+        for (std::size_t slot = 0; slot < onPage.size(); ++slot) {
+            if (onPage[slot].caption.isEmpty() || layout_.captionHeight <= 0) {
+                continue;
+            }
+            const QRect rect = captionRect(static_cast<int>(slot));
+            painter.drawText(rect,
+                             Qt::AlignHCenter | Qt::AlignTop,
+                             metrics.elidedText(onPage[slot].caption, Qt::ElideMiddle, rect.width()));
+        }
+
+        canceled = progress && !progress(page + 1, pages);
+    }
+
+    // 取消时等待已派发的页面，它们引用了 labels
+    for (auto &rendering : inFlight) {
+        rendering.image.waitForFinished();
+    }
+    painter.end();
+
+    if (canceled) {
+        file.cancelWriting();
+        error_ = QStringLiteral("Canceled");
+        return false;
+    }
+    if (!file.commit()) {
+        error_ = file.errorString();
+        spdlog::error("Failed to write PDF {}: {}", path.toStdString(), error_.toStdString());
+        return false;
+    }
+    spdlog::info("Wrote {} labels to {} ({} pages, {} per page)", labels.size(), path.toStdString(), pages, perPage);
+    return true;
+}
+
+} // namespace io
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QImage>
+#include <QMarginsF>
+#include <QPageSize>
+#include <QRect>
+#include <QSizeF>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <span>
+
+namespace batch {
+class MemoryBudget;
+} // namespace batch
+
+namespace io {
+
+/**
+ * @brief 打印排版参数，长度单位均为毫米
+ */
+struct SheetLayout {
+    QPageSize::PageSizeId pageSize = QPageSize::A4; /**< 纸张尺寸，纵向 */
+    QMarginsF margins{10, 10, 10, 10};              /**< 页边距 */
+    QSizeF labelSize{25, 25};                       /**< 单个条码的物理尺寸 */
+    double gap = 4;                                 /**< 相邻标签之间的间距 */
+    double captionHeight = 4;                       /**< 条码下方说明文字的高度，0 表示不打印说明 */
+    int dpi = 300;                                  /**< 页面栅格化分辨率 */
+
+    /**
+     * @brief 每行可放下的标签数
+     */
+    int columns() const;
+
+    /**
+     * @brief 每页可放下的标签行数
+     */
+    int rows() const;
+
+    int labelsPerPage() const {
+        return columns() * rows();
+    }
+};
+
+/**
+ * @brief 一个待打印的标签
+ */
+struct SheetLabel {
+    QImage image;    /**< 条码图片，按 SheetLayout::labelSize 缩放 */
+    QString caption; /**< 说明文字，为空时不打印 */
+};
+
+/**
+ * @class PrintSheetWriter
+ * @brief 将大量条码按网格排版到多页 PDF
+ *
+ * 每页的条码在线程池中并行栅格化为 1 位黑白图，按页序写入 PDF；说明文字以矢量文本写入，可检索。
+ * 一次只保留一个窗口（约两倍线程数）的页面，内存占用与总页数无关；
+ * 给定内存预算时每页栅格化前先申请一页的许可，写入该页后归还，预算紧张时窗口随之缩小。
+ * 标签位置按毫米计算后取整到 dpi 网格，图片不做平滑缩放，条码模块边缘保持锐利。
+ *
+ * 写入临时文件，成功后才替换目标文件，取消或失败不会留下不完整的 PDF。
+ */
+class PrintSheetWriter {
+public:
+    /**
+     * @brief 每写完一页回调一次，返回 false 时取消
+     */
+    using Progress = std::function<bool(int pagesDone, int pageCount)>;
+
+    /**
+     * @param layout 排版参数
+     * @param budget 批处理共用的内存预算，可为空
+     */
+    explicit PrintSheetWriter(SheetLayout layout, std::shared_ptr<batch::MemoryBudget> budget = nullptr);
+
+    /**
+     * @brief 排版并写入 PDF，阻塞直到完成，可在后台线程调用
+     * @return 失败或取消时返回 false，原因见 errorString()
+     */
+    bool write(const QString &path, std::span<const SheetLabel> labels, const Progress &progress = {});
+
+    /**
+     * @brief 排版所需的页数
+     */
+    int pageCount(std::size_t labelCount) const;
+
+    QString errorString() const {
+        return error_;
+    }
+
+private:
+    /**
+     * @brief 第 slot 个格子（页内序号）中条码图片的位置，单位为 dpi 像素
+     */
+    QRect labelRect(int slot) const;
+
+    QRect captionRect(int slot) const;
+
+    QImage renderPage(std::span<const SheetLabel> labels) const;
+
+    int toPixels(double mm) const;
+
+    const SheetLayout layout_;
+    const std::shared_ptr<batch::MemoryBudget> budget_;
+    QString error_;
+};
+
+} // namespace io
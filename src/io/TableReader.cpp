@@ -0,0 +1,407 @@
+#include "TableReader.h"
+#include "ArchiveReader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTextCodec>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace io {
+
+namespace {
+
+/**
+ * @brief 逐块读取的 CSV，解析状态只保存在当前行
+ */
+class CsvReader final : public TableReader {
+public:
+    explicit CsvReader(const QString &path)
+        : file_(path) {}
+
+    bool open(QString &error) {
+        if (!file_.open(QIODevice::ReadOnly)) {
+            error = file_.errorString();
+            return false;
+        }
+        fill();
+        if (buffer_.startsWith("\xEF\xBB\xBF")) {
+            pos_ = 3;
+        } else {
+            // 只检查第一块：没有 BOM 且不是合法 UTF-8 时按本地编码解码
+            QTextCodec::ConverterState state;
+            QTextCodec::codecForName("UTF-8")->toUnicode(buffer_.constData(), buffer_.size(), &state);
+            local8Bit_ = state.invalidChars > 0;
+        }
+        delimiter_ = QFileInfo(file_.fileName()).suffix().compare("tsv", Qt::CaseInsensitive) == 0
+                         ? '\t'
+                         : sniffDelimiter();
+
+        if (!readRecord(header_)) {
+            error = error_.isEmpty() ? QStringLiteral("Empty table") : error_;
+            return false;
+        }
+        return true;
+    }
+
+    bool next(QStringList &row) override {
+        while (readRecord(row)) {
+            if (row.size() == 1 && row.front().isEmpty()) {
+                continue; // 空行
+            }
+            ++rowNumber_;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static constexpr qint64 kBlockSize = 1 << 20;
+
+    bool fill() {
+        buffer_ = file_.read(kBlockSize);
+        pos_ = 0;
+        if (buffer_.isEmpty()) {
+            if (file_.error() != QFileDevice::NoError) {
+                error_ = file_.errorString();
+            }
+            return false;
+        }
+        return true;
+    }
+
+    int get() {
+        if (pos_ >= buffer_.size() && !fill()) {
+            return -1;
+        }
+        return static_cast<uchar>(buffer_[pos_++]);
+    }
+
+    int peek() {
+        if (pos_ >= buffer_.size() && !fill()) {
+            return -1;
+        }
+        return static_cast<uchar>(buffer_[pos_]);
+    }
+
+    /**
+     * @brief 统计表头行中引号外各候选分隔符的个数，取最多的一个
+     */
+    char sniffDelimiter() const {
+        static constexpr char candidates[] = {',', ';', '\t'};
+        int counts[std::size(candidates)] = {};
+        bool quoted = false;
+        for (int i = pos_; i < buffer_.size(); ++i) {
+            const char c = buffer_[i];
+            if (c == '"') {
+                quoted = !quoted;
+            } else if (!quoted && (c == '\n' || c == '\r')) {
+                break;
+            } else if (!quoted) {
+                for (std::size_t k = 0; k < std::size(candidates); ++k) {
+                    counts[k] += c == candidates[k];
+                }
+            }
+        }
+        const auto best = std::max_element(std::begin(counts), std::end(counts)) - std::begin(counts);
+        return counts[best] > 0 ? candidates[best] : ',';
+    }
+
+    QString decode(const QByteArray &bytes) const {
+        return local8Bit_ ? QString::fromLocal8Bit(bytes) : QString::fromUtf8(bytes);
+    }
+
+    bool readRecord(QStringList &row) {
+        row.clear();
+        int c = get();
+        if (c < 0) {
+            return false;
+        }
+
+        QByteArray field;
+        bool inQuotes = false;
+        for (; c >= 0; c = get()) {
+            if (inQuotes) {
+                if (c != '"') {
+                    field += static_cast<char>(c);
+                } else if (peek() == '"') {
+                    get();
+                    field += '"';
+                } else {
+                    inQuotes = false;
+                }
+            } else if (c == '"' && field.isEmpty()) {
+                inQuotes = true;
+            } else if (c == delimiter_) {
+                row.append(decode(field));
+                field.clear();
+            } else if (c == '\n' || c == '\r') {
+                if (c == '\r' && peek() == '\n') {
+                    get();
+                }
+                row.append(decode(field));
+                return true;
+            } else {
+                field += static_cast<char>(c);
+            }
+        }
+        // 最后一行没有换行符
+        row.append(decode(field));
+        return error_.isEmpty();
+    }
+
+    QFile file_;
+    QByteArray buffer_;
+    int pos_ = 0;
+    char delimiter_ = ',';
+    bool local8Bit_ = false;
+};
+
+/**
+ * @brief 拼接 <si>/<is> 下全部 <t> 的文本，富文本的每个 <r> 各有一个 <t>，注音 <rPh> 忽略
+ */
+QString readText(QXmlStreamReader &xml) {
+    QString text;
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("t")) {
+            text += xml.readElementText();
+        } else if (xml.name() == QLatin1String("r")) {
+            text += readText(xml);
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+    return text;
+}
+
+constexpr int kMaxColumns = 16384; /**< XLSX 的列数上限，最后一列为 XFD */
+
+/**
+ * @brief 单元格引用（如 "AB12"）中的列号，从 0 开始；没有列字母时返回 -1，超过 XFD 时返回 kMaxColumns
+ */
+int columnIndex(QStringView ref) {
+    int column = 0;
+    int letters = 0;
+    for (const QChar ch : ref) {
+        if (ch < 'A' || ch > 'Z') {
+            break;
+        }
+        if (++letters > 3) {
+            return kMaxColumns;
+        }
+        column = column * 26 + (ch.unicode() - 'A' + 1);
+    }
+    return letters > 0 ? std::min(column - 1, kMaxColumns) : -1;
+}
+
+/**
+ * @brief 流式读取 XLSX 的第一个工作表
+ */
+class XlsxReader final : public TableReader {
+public:
+    bool open(const QString &path, QString &error) {
+        archive_ = ArchiveReader::open(path, &error);
+        if (!archive_) {
+            return false;
+        }
+
+        const QString sheetPath = firstSheetPath();
+        const auto *sheet = archive_->find(sheetPath);
+        if (!sheet) {
+            error = QStringLiteral("Worksheet not found: %1").arg(sheetPath);
+            return false;
+        }
+        if (const auto *strings = archive_->find(QStringLiteral("xl/sharedStrings.xml"));
+            strings && !loadSharedStrings(*strings, error)) {
+            return false;
+        }
+
+        sheet_ = archive_->openStream(*sheet, &error);
+        if (!sheet_) {
+            return false;
+        }
+        xml_.setDevice(sheet_.get());
+
+        if (!readRow(header_)) {
+            error = error_.isEmpty() ? QStringLiteral("Empty table") : error_;
+            return false;
+        }
+        return true;
+    }
+
+    bool next(QStringList &row) override {
+        while (readRow(row)) {
+            if (std::all_of(row.cbegin(), row.cend(), [](const QString &cell) { return cell.isEmpty(); })) {
+                continue;
+            }
+            ++rowNumber_;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    /**
+     * @brief 按 workbook.xml 与其关系文件找到第一个工作表，解析失败时退回 sheet1.xml
+     */
+    QString firstSheetPath() const {
+        QString relationId;
+        if (const auto *workbook = archive_->find(QStringLiteral("xl/workbook.xml"))) {
+            if (const auto data = archive_->read(*workbook)) {
+                QXmlStreamReader xml(*data);
+                while (relationId.isEmpty() && !xml.atEnd()) {
+                    if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("sheet")) {
+                        continue;
+                    }
+                    for (const auto &attribute : xml.attributes()) {
+                        if (attribute.name() == QLatin1String("id")) { // r:id
+                            relationId = attribute.value().toString();
+                        }
+                    }
+                }
+            }
+        }
+
+        if (const auto *rels = archive_->find(QStringLiteral("xl/_rels/workbook.xml.rels"));
+            rels && !relationId.isEmpty()) {
+            if (const auto data = archive_->read(*rels)) {
+                QXmlStreamReader xml(*data);
+                while (!xml.atEnd()) {
+                    if (xml.readNext() != QXmlStreamReader::StartElement ||
+                        xml.name() != QLatin1String("Relationship") || xml.attributes().value("Id") != relationId) {
+                        continue;
+                    }
+                    const QString target = xml.attributes().value("Target").toString();
+                    return target.startsWith('/') ? target.mid(1) : QStringLiteral("xl/") + target;
+                }
+            }
+        }
+        return QStringLiteral("xl/worksheets/sheet1.xml");
+    }
+
+    bool loadSharedStrings(const ArchiveEntry &entry, QString &error) {
+        const auto device = archive_->openStream(entry, &error);
+        if (!device) {
+            return false;
+        }
+        QXmlStreamReader xml(device.get());
+        while (!xml.atEnd()) {
+            if (xml.readNext() == QXmlStreamReader::StartElement && xml.name() == QLatin1String("si")) {
+                strings_.push_back(readText(xml));
+            }
+        }
+        if (xml.hasError()) {
+            error = QStringLiteral("sharedStrings.xml: %1").arg(xml.errorString());
+            return false;
+        }
+        spdlog::debug("Loaded {} shared strings", strings_.size());
+        return true;
+    }
+
+    bool readRow(QStringList &row) {
+        row.clear();
+        while (!xml_.atEnd()) {
+            if (xml_.readNext() == QXmlStreamReader::StartElement && xml_.name() == QLatin1String("row")) {
+                while (xml_.readNextStartElement()) {
+                    if (xml_.name() == QLatin1String("c")) {
+                        readCell(row);
+                    } else {
+                        xml_.skipCurrentElement();
+                    }
+                }
+                break;
+            }
+        }
+        if (xml_.hasError()) {
+            error_ = xml_.errorString();
+            return false;
+        }
+        return !xml_.atEnd() || !row.isEmpty();
+    }
+
+    void readCell(QStringList &row) {
+        const auto attributes = xml_.attributes();
+        const QString type = attributes.value("t").toString();
+        int column = columnIndex(attributes.value("r"));
+        if (column < 0) {
+            column = static_cast<int>(row.size());
+        }
+        if (column >= kMaxColumns) {
+            // 补齐空单元格前拒绝，伪造的引用不会让一行膨胀到上亿列
+            xml_.raiseError(QStringLiteral("Cell reference out of range: %1").arg(attributes.value("r").toString()));
+            return;
+        }
+
+        QString value;
+        while (xml_.readNextStartElement()) {
+            if (xml_.name() == QLatin1String("v")) {
+                value = xml_.readElementText();
+            } else if (xml_.name() == QLatin1String("is")) {
+                value = readText(xml_);
+            } else {
+                xml_.skipCurrentElement(); // 公式 <f> 等
+            }
+        }
+
+        if (type == QLatin1String("s")) {
+            bool ok = false;
+            const auto index = value.toULongLong(&ok);
+            value = ok && index < strings_.size() ? strings_[index] : QString();
+        } else if (type == QLatin1String("b")) {
+            value = value == QLatin1String("1") ? QStringLiteral("TRUE") : QStringLiteral("FALSE");
+        }
+
+        // 省略的空单元格补齐为空字符串
+        while (row.size() < column) {
+            row.append(QString());
+        }
+        if (row.size() == column) {
+            row.append(value);
+        } else {
+            row[column] = value;
+        }
+    }
+
+    std::shared_ptr<ArchiveReader> archive_;
+    std::vector<QString> strings_;
+    std::unique_ptr<QIODevice> sheet_;
+    QXmlStreamReader xml_;
+};
+
+} // namespace
+
+bool TableReader::isTablePath(const QString &path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "csv" || suffix == "tsv" || suffix == "xlsx";
+}
+
+std::unique_ptr<TableReader> TableReader::open(const QString &path, QString *errorString) {
+    QString error;
+    std::unique_ptr<TableReader> table;
+
+    if (QFileInfo(path).suffix().compare("xlsx", Qt::CaseInsensitive) == 0) {
+        auto xlsx = std::make_unique<XlsxReader>();
+        if (xlsx->open(path, error)) {
+            table = std::move(xlsx);
+        }
+    } else {
+        auto csv = std::make_unique<CsvReader>(path);
+        if (csv->open(error)) {
+            table = std::move(csv);
+        }
+    }
+
+    if (!table) {
+        spdlog::error("Failed to open table {}: {}", path.toStdString(), error.toStdString());
+        if (errorString) {
+            *errorString = error;
+        }
+        return nullptr;
+    }
+    spdlog::info("Opened table {} with {} columns", path.toStdString(), table->header().size());
+    return table;
+}
+
+} // namespace io
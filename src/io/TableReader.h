@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+namespace io {
+
+/**
+ * @class TableReader
+ * @brief 逐行流式读取表格，内存占用与文件大小无关
+ *
+ * 第一行作为表头，next() 每次只解析一行数据。
+ * CSV 按块读取，支持 RFC 4180 的引号、转义和字段内换行，分隔符从表头行推断（逗号、分号或制表符），
+ * 非 UTF-8 编码的文件按系统本地编码解码（例如中文 Windows 上 Excel 导出的 GBK）。
+ * XLSX 只读取第一个工作表，工作表 XML 边解压边解析；共享字符串表需要常驻内存。
+ * 单元格取存储的原始值，数字和日期不套用单元格格式。
+ *
+ * 对象只能在一个线程中使用，可以在界面线程打开、读取表头后交给后台线程读取数据行。
+ */
+class TableReader {
+public:
+    virtual ~TableReader() = default;
+
+    /**
+     * @brief 根据后缀判断是否为支持的表格（csv、tsv、xlsx）
+     */
+    static bool isTablePath(const QString &path);
+
+    /**
+     * @brief 打开表格并读取表头
+     * @param errorString 失败时写入原因，可为空
+     * @return 失败时返回 nullptr
+     */
+    static std::unique_ptr<TableReader> open(const QString &path, QString *errorString = nullptr);
+
+    /**
+     * @brief 表头（第一行）
+     */
+    const QStringList &header() const noexcept {
+        return header_;
+    }
+
+    /**
+     * @brief 读取下一行数据，跳过空行
+     * @return 到达末尾或出错时返回 false，出错时 errorString() 非空
+     */
+    virtual bool next(QStringList &row) = 0;
+
+    /**
+     * @brief 最近读取的数据行号，从 1 开始，不含表头
+     */
+    qint64 rowNumber() const noexcept {
+        return rowNumber_;
+    }
+
+    QString errorString() const {
+        return error_;
+    }
+
+protected:
+    QStringList header_;
+    qint64 rowNumber_ = 0;
+    QString error_;
+};
+
+} // namespace io
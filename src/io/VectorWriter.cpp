@@ -0,0 +1,128 @@
+#include "VectorWriter.h"
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+namespace io {
+
+namespace {
+
+constexpr double kMmPerInch = 25.4;
+constexpr double kPointsPerInch = 72;
+
+QByteArray number(double value) {
+    return QByteArray::number(value, 'f', 4);
+}
+
+} // namespace
+
+std::vector<QRect> VectorWriter::mergeModules(const ZXing::BitMatrix &bits) {
+    std::vector<QRect> rects;
+    std::vector<std::size_t> open; // 上一行各段对应的矩形，按 x 递增
+    std::vector<std::size_t> next;
+
+    for (int y = 0; y < bits.height(); ++y) {
+        next.clear();
+        std::size_t k = 0;
+        for (int x = 0; x < bits.width();) {
+            if (!bits.get(x, y)) {
+                ++x;
+                continue;
+            }
+            const int begin = x;
+            while (x < bits.width() && bits.get(x, y)) {
+                ++x;
+            }
+
+            while (k < open.size() && rects[open[k]].left() < begin) {
+                ++k;
+            }
+            if (k < open.size() && rects[open[k]].left() == begin && rects[open[k]].width() == x - begin) {
+                // 与上一行的段完全对齐，向下延伸
+                rects[open[k]].setHeight(rects[open[k]].height() + 1);
+                next.push_back(open[k++]);
+            } else {
+                rects.emplace_back(begin, y, x - begin, 1);
+                next.push_back(rects.size() - 1);
+            }
+        }
+        open.swap(next);
+    }
+    return rects;
+}
+
+QByteArray VectorWriter::toSvg(const ZXing::BitMatrix &bits, QSizeF sizeMm) {
+    const auto rects = mergeModules(bits);
+    const QByteArray width = QByteArray::number(bits.width());
+    const QByteArray height = QByteArray::number(bits.height());
+
+    QByteArray svg;
+    svg.reserve(static_cast<int>(rects.size()) * 24 + 512);
+    svg += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    svg += "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" + number(sizeMm.width()) +
+           "mm\" height=\"" + number(sizeMm.height()) + "mm\" viewBox=\"0 0 " + width + ' ' + height +
+           "\" preserveAspectRatio=\"none\" shape-rendering=\"crispEdges\">\n";
+    svg += "<rect width=\"" + width + "\" height=\"" + height + "\" fill=\"#fff\"/>\n";
+    svg += "<path fill=\"#000\" d=\"";
+    for (const auto &rect : rects) {
+        const QByteArray w = QByteArray::number(rect.width());
+        svg += 'M' + QByteArray::number(rect.x()) + ' ' + QByteArray::number(rect.y()) + 'h' + w + 'v' +
+               QByteArray::number(rect.height()) + "h-" + w + 'z';
+    }
+    svg += "\"/>\n</svg>\n";
+    return svg;
+}
+
+QByteArray VectorWriter::toPdf(const ZXing::BitMatrix &bits, QSizeF sizeMm) {
+    const auto rects = mergeModules(bits);
+    const double width = sizeMm.width() / kMmPerInch * kPointsPerInch;
+    const double height = sizeMm.height() / kMmPerInch * kPointsPerInch;
+
+    // 以模块为单位绘制：缩放到页面大小并翻转 y 轴，使原点在左上角
+    QByteArray content;
+    content.reserve(static_cast<int>(rects.size()) * 20 + 128);
+    content += "q 0 g " + number(width / bits.width()) + " 0 0 " + number(-height / bits.height()) + " 0 " +
+               number(height) + " cm\n";
+    for (const auto &rect : rects) {
+        content += QByteArray::number(rect.x()) + ' ' + QByteArray::number(rect.y()) + ' ' +
+                   QByteArray::number(rect.width()) + ' ' + QByteArray::number(rect.height()) + " re\n";
+    }
+    content += "f Q\n";
+
+    QByteArray stream(static_cast<int>(compressBound(static_cast<uLong>(content.size()))), Qt::Uninitialized);
+    auto streamSize = static_cast<uLongf>(stream.size());
+    QByteArray filter = " /Filter /FlateDecode";
+    if (compress2(reinterpret_cast<Bytef *>(stream.data()),
+                  &streamSize,
+                  reinterpret_cast<const Bytef *>(content.constData()),
+                  static_cast<uLong>(content.size()),
+                  Z_DEFAULT_COMPRESSION) == Z_OK) {
+        stream.resize(static_cast<int>(streamSize));
+    } else {
+        spdlog::warn("PDF content compression failed, writing uncompressed");
+        stream = content;
+        filter.clear();
+    }
+
+    QByteArray pdf = "%PDF-1.4\n%\xE2\xE3\xCF\xD3\n";
+    std::vector<int> offsets;
+    const auto object = [&](const QByteArray &body) {
+        offsets.push_back(pdf.size());
+        pdf += QByteArray::number(static_cast<int>(offsets.size())) + " 0 obj\n" + body + "\nendobj\n";
+    };
+    object("<< /Type /Catalog /Pages 2 0 R >>");
+    object("<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+    object("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + number(width) + ' ' + number(height) +
+           "] /Contents 4 0 R /Resources << >> >>");
+    object("<< /Length " + QByteArray::number(stream.size()) + filter + " >>\nstream\n" + stream + "\nendstream");
+
+    const int xref = pdf.size();
+    pdf += "xref\n0 " + QByteArray::number(static_cast<int>(offsets.size()) + 1) + "\n0000000000 65535 f \n";
+    for (const int offset : offsets) {
+        pdf += QByteArray::number(offset).rightJustified(10, '0') + " 00000 n \n";
+    }
+    pdf += "trailer\n<< /Size " + QByteArray::number(static_cast<int>(offsets.size()) + 1) +
+           " /Root 1 0 R >>\nstartxref\n" + QByteArray::number(xref) + "\n%%EOF\n";
+    return pdf;
+}
+
+} // namespace io
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QByteArray>
+#include <QRect>
+#include <QSizeF>
+#include <ZXing/BitMatrix.h>
+#include <vector>
+
+namespace io {
+
+/**
+ * @class VectorWriter
+ * @brief 直接从条码的模块矩阵输出矢量图形（SVG / PDF）
+ *
+ * 每行的连续黑色模块先合并为一段，再与上一行位置和长度都相同的段纵向合并为矩形，
+ * 二维码的矩形数通常只有模块数的几分之一。输出与分辨率无关，文件只有几 KB，
+ * 不需要先按打印尺寸栅格化成大图。
+ */
+class VectorWriter {
+public:
+    /**
+     * @brief 合并黑色模块，坐标以模块为单位
+     */
+    static std::vector<QRect> mergeModules(const ZXing::BitMatrix &bits);
+
+    /**
+     * @brief 输出 SVG，sizeMm 为图形的物理尺寸（毫米），白底
+     */
+    static QByteArray toSvg(const ZXing::BitMatrix &bits, QSizeF sizeMm);
+
+    /**
+     * @brief 输出单页 PDF，页面大小即 sizeMm，内容流用 deflate 压缩
+     */
+    static QByteArray toPdf(const ZXing::BitMatrix &bits, QSizeF sizeMm);
+};
+
+} // namespace io